@@ -194,7 +194,7 @@ namespace chacha_detail {
                               _mm_srli_epi32((r), 32-(c)))          \
         )
 #else
-#define CHACHA_roti_epi32(r, c) _mm_xor_si128(
+#define CHACHA_roti_epi32(r, c) _mm_xor_si128( \
     _mm_slli_epi32((r), (c)), \
         _mm_srli_epi32((r), 32 - (c)))
 #endif
@@ -14,6 +14,7 @@
 
 // CHANGELOG
 // (minor and older changes stripped away, please see git history for details)
+//  2026-10-19: OpenGL: Optional triple buffered vertex/index ring with fences, persistently mapped on GL 4.4+, all draw lists of a frame uploaded into one region. See ImGui_ImplOpenGL3_SetBufferRing().
 //  2022-05-23: OpenGL: Reworking 2021-12-15 "Using buffer orphaning" so it only happens on Intel GPU, seems to cause problems otherwise. (#4468, #4825, #4832, #5127).
 //  2022-05-13: OpenGL: Fix state corruption on OpenGL ES 2.0 due to not preserving GL_ELEMENT_ARRAY_BUFFER_BINDING and vertex attribute states.
 //  2021-12-15: OpenGL: Using buffer orphaning + glBufferSubData(), seems to fix leaks with multi-viewports with some Intel HD drivers.
@@ -163,6 +164,12 @@
 #define IMGUI_IMPL_OPENGL_MAY_HAVE_VTX_OFFSET
 #endif
 
+// Desktop GL 3.2+ has fences and glDrawElementsBaseVertex(), which the optional buffer ring needs
+#if !defined(IMGUI_IMPL_OPENGL_ES2) && !defined(IMGUI_IMPL_OPENGL_ES3) && defined(GL_VERSION_3_2)
+#define IMGUI_IMPL_OPENGL_MAY_HAVE_BUFFER_RING
+#define IMGUI_IMPL_OPENGL_RING_REGIONS 3     // One being written, up to two still in flight
+#endif
+
 // Desktop GL 3.3+ has glBindSampler()
 #if !defined(IMGUI_IMPL_OPENGL_ES2) && !defined(IMGUI_IMPL_OPENGL_ES3) && defined(GL_VERSION_3_3)
 #define IMGUI_IMPL_OPENGL_MAY_HAVE_BIND_SAMPLER
@@ -195,6 +202,17 @@ struct ImGui_ImplOpenGL3_Data
     GLsizeiptr      IndexBufferSize;
     bool            HasClipOrigin;
     bool            UseBufferSubData;
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_BUFFER_RING
+    bool            HasBufferStorage;        // GL 4.4 or GL_ARB_buffer_storage: the ring is mapped once and stays mapped
+    bool            UseBufferRing;           // Set with ImGui_ImplOpenGL3_SetBufferRing()
+    GLuint          RingVboHandle, RingElementsHandle;
+    int             RingVtxCapacity;         // Vertices and indices per region, each buffer holds IMGUI_IMPL_OPENGL_RING_REGIONS regions
+    int             RingIdxCapacity;
+    int             RingRegion;              // Region the next frame writes to
+    ImDrawVert*     RingVtxMapped;           // Persistent mappings, NULL when mapping unsynchronized every frame
+    ImDrawIdx*      RingIdxMapped;
+    GLsync          RingFences[IMGUI_IMPL_OPENGL_RING_REGIONS]; // Signaled when the GPU is done with the frame that last used each region
+#endif
 
     ImGui_ImplOpenGL3_Data() { memset((void*)this, 0, sizeof(*this)); }
 };
@@ -313,8 +331,16 @@ bool    ImGui_ImplOpenGL3_Init(const char* glsl_version)
         const char* extension = (const char*)glGetStringi(GL_EXTENSIONS, i);
         if (extension != NULL && strcmp(extension, "GL_ARB_clip_control") == 0)
             bd->HasClipOrigin = true;
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_BUFFER_RING
+        if (extension != NULL && strcmp(extension, "GL_ARB_buffer_storage") == 0)
+            bd->HasBufferStorage = true;
+#endif
     }
 #endif
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_BUFFER_RING
+    if (bd->GlVersion >= 440)
+        bd->HasBufferStorage = true;
+#endif
 
     return true;
 }
@@ -403,8 +429,18 @@ static void ImGui_ImplOpenGL3_SetupRenderState(ImDrawData* draw_data, int fb_wid
 #endif
 
     // Bind vertex/index buffers and setup attributes for ImDrawVert
-    glBindBuffer(GL_ARRAY_BUFFER, bd->VboHandle);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, bd->ElementsHandle);
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_BUFFER_RING
+    if (bd->UseBufferRing)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, bd->RingVboHandle);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, bd->RingElementsHandle);
+    }
+    else
+#endif
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, bd->VboHandle);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, bd->ElementsHandle);
+    }
     glEnableVertexAttribArray(bd->AttribLocationVtxPos);
     glEnableVertexAttribArray(bd->AttribLocationVtxUV);
     glEnableVertexAttribArray(bd->AttribLocationVtxColor);
@@ -413,6 +449,135 @@ static void ImGui_ImplOpenGL3_SetupRenderState(ImDrawData* draw_data, int fb_wid
     glVertexAttribPointer(bd->AttribLocationVtxColor, 4, GL_UNSIGNED_BYTE, GL_TRUE,  sizeof(ImDrawVert), (GLvoid*)IM_OFFSETOF(ImDrawVert, col));
 }
 
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_BUFFER_RING
+static void ImGui_ImplOpenGL3_DestroyBufferRing()
+{
+    ImGui_ImplOpenGL3_Data* bd = ImGui_ImplOpenGL3_GetBackendData();
+    for (int i = 0; i < IMGUI_IMPL_OPENGL_RING_REGIONS; i++)
+        if (bd->RingFences[i]) { glDeleteSync(bd->RingFences[i]); bd->RingFences[i] = NULL; }
+    // Deleting a buffer also unmaps it, and the driver keeps it alive until frames still in flight are done with it
+    if (bd->RingVboHandle)      { glDeleteBuffers(1, &bd->RingVboHandle); bd->RingVboHandle = 0; }
+    if (bd->RingElementsHandle) { glDeleteBuffers(1, &bd->RingElementsHandle); bd->RingElementsHandle = 0; }
+    bd->RingVtxMapped = NULL;
+    bd->RingIdxMapped = NULL;
+    bd->RingVtxCapacity = bd->RingIdxCapacity = 0;
+    bd->RingRegion = 0;
+}
+
+// Both buffers are only ever bound to GL_ARRAY_BUFFER here, binding GL_ELEMENT_ARRAY_BUFFER would need a VAO
+static GLuint ImGui_ImplOpenGL3_CreateRingBuffer(GLsizeiptr size, void** mapped)
+{
+    ImGui_ImplOpenGL3_Data* bd = ImGui_ImplOpenGL3_GetBackendData();
+    GLuint handle = 0;
+    glGenBuffers(1, &handle);
+    glBindBuffer(GL_ARRAY_BUFFER, handle);
+    *mapped = NULL;
+    if (bd->HasBufferStorage)
+    {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_ARRAY_BUFFER, size, NULL, flags);
+        *mapped = glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags);
+    }
+    else
+    {
+        glBufferData(GL_ARRAY_BUFFER, size, NULL, GL_STREAM_DRAW);
+    }
+    return handle;
+}
+
+// Grows the ring so one region holds a whole frame, capacities double to keep reallocations rare
+static void ImGui_ImplOpenGL3_ReserveBufferRing(int vtx_count, int idx_count)
+{
+    ImGui_ImplOpenGL3_Data* bd = ImGui_ImplOpenGL3_GetBackendData();
+    if (bd->RingVboHandle && vtx_count <= bd->RingVtxCapacity && idx_count <= bd->RingIdxCapacity)
+        return;
+    int vtx_capacity = bd->RingVtxCapacity > (1 << 14) ? bd->RingVtxCapacity : (1 << 14);
+    int idx_capacity = bd->RingIdxCapacity > (1 << 15) ? bd->RingIdxCapacity : (1 << 15);
+    while (vtx_capacity < vtx_count)
+        vtx_capacity *= 2;
+    while (idx_capacity < idx_count)
+        idx_capacity *= 2;
+    ImGui_ImplOpenGL3_DestroyBufferRing();
+    void* vtx_mapped;
+    void* idx_mapped;
+    bd->RingVboHandle = ImGui_ImplOpenGL3_CreateRingBuffer((GLsizeiptr)vtx_capacity * IMGUI_IMPL_OPENGL_RING_REGIONS * (int)sizeof(ImDrawVert), &vtx_mapped);
+    bd->RingElementsHandle = ImGui_ImplOpenGL3_CreateRingBuffer((GLsizeiptr)idx_capacity * IMGUI_IMPL_OPENGL_RING_REGIONS * (int)sizeof(ImDrawIdx), &idx_mapped);
+    bd->RingVtxMapped = (ImDrawVert*)vtx_mapped;
+    bd->RingIdxMapped = (ImDrawIdx*)idx_mapped;
+    bd->RingVtxCapacity = vtx_capacity;
+    bd->RingIdxCapacity = idx_capacity;
+}
+
+static void ImGui_ImplOpenGL3_WriteBufferRing(ImDrawData* draw_data, GLuint handle, void* mapped, GLsizeiptr offset, GLsizeiptr size, bool indices)
+{
+    if (size == 0)
+        return;
+    char* dst = (char*)mapped;
+    if (dst != NULL)
+    {
+        dst += offset;
+    }
+    else
+    {
+        // The fence already guarantees the GPU is done with this range, so the driver has nothing to wait for
+        glBindBuffer(GL_ARRAY_BUFFER, handle);
+        dst = (char*)glMapBufferRange(GL_ARRAY_BUFFER, offset, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        if (dst == NULL)
+            return;
+    }
+    for (int n = 0; n < draw_data->CmdListsCount; n++)
+    {
+        const ImDrawList* cmd_list = draw_data->CmdLists[n];
+        const size_t bytes = indices ? (size_t)cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx) : (size_t)cmd_list->VtxBuffer.Size * sizeof(ImDrawVert);
+        memcpy(dst, indices ? (const void*)cmd_list->IdxBuffer.Data : (const void*)cmd_list->VtxBuffer.Data, bytes);
+        dst += bytes;
+    }
+    if (mapped == NULL)
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+}
+
+// Writes every draw list of the frame into the next region, returns the region's first vertex and index
+static void ImGui_ImplOpenGL3_UploadBufferRing(ImDrawData* draw_data, int* vtx_offset, int* idx_offset)
+{
+    ImGui_ImplOpenGL3_Data* bd = ImGui_ImplOpenGL3_GetBackendData();
+    ImGui_ImplOpenGL3_ReserveBufferRing(draw_data->TotalVtxCount, draw_data->TotalIdxCount);
+    const int region = bd->RingRegion;
+
+    // Wait for the GPU to finish the frame that last used this region, usually long done with two frames in between
+    if (GLsync fence = bd->RingFences[region])
+    {
+        GLenum status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+        while (status == GL_TIMEOUT_EXPIRED)
+            status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000); // 1 ms
+        glDeleteSync(fence);
+        bd->RingFences[region] = NULL;
+    }
+
+    *vtx_offset = region * bd->RingVtxCapacity;
+    *idx_offset = region * bd->RingIdxCapacity;
+    ImGui_ImplOpenGL3_WriteBufferRing(draw_data, bd->RingVboHandle, bd->RingVtxMapped, (GLsizeiptr)*vtx_offset * (int)sizeof(ImDrawVert), (GLsizeiptr)draw_data->TotalVtxCount * (int)sizeof(ImDrawVert), false);
+    ImGui_ImplOpenGL3_WriteBufferRing(draw_data, bd->RingElementsHandle, bd->RingIdxMapped, (GLsizeiptr)*idx_offset * (int)sizeof(ImDrawIdx), (GLsizeiptr)draw_data->TotalIdxCount * (int)sizeof(ImDrawIdx), true);
+}
+#endif
+
+bool    ImGui_ImplOpenGL3_SetBufferRing(bool enabled)
+{
+    ImGui_ImplOpenGL3_Data* bd = ImGui_ImplOpenGL3_GetBackendData();
+    IM_ASSERT(bd != NULL && "Did you call ImGui_ImplOpenGL3_Init()?");
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_BUFFER_RING
+    if (bd->GlVersion < 320)
+        enabled = false;
+    if (!enabled)
+        ImGui_ImplOpenGL3_DestroyBufferRing();
+    bd->UseBufferRing = enabled;
+    return enabled;
+#else
+    (void)bd;
+    (void)enabled;
+    return false;
+#endif
+}
+
 // OpenGL3 Render function.
 // Note that this implementation is little overcomplicated because we are saving/setting up/restoring every OpenGL state explicitly.
 // This is in order to be able to run within an OpenGL engine that doesn't do so.
@@ -472,6 +637,17 @@ void    ImGui_ImplOpenGL3_RenderDrawData(ImDrawData* draw_data)
 #ifdef IMGUI_IMPL_OPENGL_USE_VERTEX_ARRAY
     glGenVertexArrays(1, &vertex_array_object);
 #endif
+
+    // With the buffer ring, the whole frame is uploaded up front and every list is drawn at its offset in the region
+    int global_vtx_offset = 0;
+    int global_idx_offset = 0;
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_BUFFER_RING
+    if (bd->UseBufferRing)
+        ImGui_ImplOpenGL3_UploadBufferRing(draw_data, &global_vtx_offset, &global_idx_offset);
+    const bool use_buffer_ring = bd->UseBufferRing;
+#else
+    const bool use_buffer_ring = false;
+#endif
     ImGui_ImplOpenGL3_SetupRenderState(draw_data, fb_width, fb_height, vertex_array_object);
 
     // Will project scissor/clipping rectangles into framebuffer space
@@ -489,7 +665,11 @@ void    ImGui_ImplOpenGL3_RenderDrawData(ImDrawData* draw_data)
         // - OpenGL drivers are in a very sorry state in 2022, for now we are switching code path based on vendors.
         const GLsizeiptr vtx_buffer_size = (GLsizeiptr)cmd_list->VtxBuffer.Size * (int)sizeof(ImDrawVert);
         const GLsizeiptr idx_buffer_size = (GLsizeiptr)cmd_list->IdxBuffer.Size * (int)sizeof(ImDrawIdx);
-        if (bd->UseBufferSubData)
+        if (use_buffer_ring)
+        {
+            // Already in the ring
+        }
+        else if (bd->UseBufferSubData)
         {
             if (bd->VertexBufferSize < vtx_buffer_size)
             {
@@ -537,13 +717,27 @@ void    ImGui_ImplOpenGL3_RenderDrawData(ImDrawData* draw_data)
                 glBindTexture(GL_TEXTURE_2D, (GLuint)(intptr_t)pcmd->GetTexID());
 #ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_VTX_OFFSET
                 if (bd->GlVersion >= 320)
-                    glDrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)pcmd->ElemCount, sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, (void*)(intptr_t)(pcmd->IdxOffset * sizeof(ImDrawIdx)), (GLint)pcmd->VtxOffset);
+                    glDrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)pcmd->ElemCount, sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, (void*)(intptr_t)((pcmd->IdxOffset + global_idx_offset) * sizeof(ImDrawIdx)), (GLint)(pcmd->VtxOffset + global_vtx_offset));
                 else
 #endif
                 glDrawElements(GL_TRIANGLES, (GLsizei)pcmd->ElemCount, sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, (void*)(intptr_t)(pcmd->IdxOffset * sizeof(ImDrawIdx)));
             }
         }
+        if (use_buffer_ring)
+        {
+            global_vtx_offset += cmd_list->VtxBuffer.Size;
+            global_idx_offset += cmd_list->IdxBuffer.Size;
+        }
+    }
+
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_BUFFER_RING
+    // Fence the region so it is not overwritten before the GPU has read it
+    if (use_buffer_ring)
+    {
+        bd->RingFences[bd->RingRegion] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        bd->RingRegion = (bd->RingRegion + 1) % IMGUI_IMPL_OPENGL_RING_REGIONS;
     }
+#endif
 
     // Destroy the temporary VAO
 #ifdef IMGUI_IMPL_OPENGL_USE_VERTEX_ARRAY
@@ -863,6 +1057,9 @@ void    ImGui_ImplOpenGL3_DestroyDeviceObjects()
     if (bd->VboHandle)      { glDeleteBuffers(1, &bd->VboHandle); bd->VboHandle = 0; }
     if (bd->ElementsHandle) { glDeleteBuffers(1, &bd->ElementsHandle); bd->ElementsHandle = 0; }
     if (bd->ShaderHandle)   { glDeleteProgram(bd->ShaderHandle); bd->ShaderHandle = 0; }
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_BUFFER_RING
+    ImGui_ImplOpenGL3_DestroyBufferRing();
+#endif
     ImGui_ImplOpenGL3_DestroyFontsTexture();
 }
 
@@ -32,6 +32,10 @@ IMGUI_IMPL_API void     ImGui_ImplOpenGL3_DestroyFontsTexture();
 IMGUI_IMPL_API bool     ImGui_ImplOpenGL3_CreateDeviceObjects();
 IMGUI_IMPL_API void     ImGui_ImplOpenGL3_DestroyDeviceObjects();
 
+// (Optional) Upload each frame into one region of a triple buffered vertex/index ring guarded by fences, persistently mapped on GL 4.4+.
+// Returns false and keeps the regular path when unsupported (GL < 3.2, or ES). Call after Init.
+IMGUI_IMPL_API bool     ImGui_ImplOpenGL3_SetBufferRing(bool enabled);
+
 // Specific OpenGL ES versions
 //#define IMGUI_IMPL_OPENGL_ES2     // Auto-detected on Emscripten
 //#define IMGUI_IMPL_OPENGL_ES3     // Auto-detected on iOS/Android
@@ -0,0 +1,664 @@
+﻿// minesweeper.h : board generation, neighbor counting and reveal logic
+// shared by the game and the solver.
+
+#pragma once
+
+#include "sodium/crypto_stream_xchacha20.h"
+#include "sodium/randombytes.h"
+#include <vector>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <cmath>
+
+enum class mine_flag : uint16_t {
+	hidden = 0x1,
+	flagged = 0x2,
+	mine = 0x4,
+	flood = 0x8,
+};
+
+struct mine {
+	uint16_t nearby = {};
+	uint16_t flags = {};
+};
+
+constexpr bool is_mine(const mine& m) noexcept {
+	return m.flags & (uint16_t)mine_flag::mine;
+}
+
+constexpr bool is_flagged(const mine& m) noexcept {
+	return m.flags & (uint16_t)mine_flag::flagged;
+}
+
+constexpr bool is_hidden(const mine& m) noexcept {
+	return m.flags & (uint16_t)mine_flag::hidden;
+}
+
+constexpr bool is_near_mine(const mine& m) noexcept {
+	return m.nearby > 0;
+}
+
+constexpr bool is_flooded(const mine& m) noexcept {
+	return m.flags & (uint16_t)mine_flag::flood;
+}
+
+inline uint32_t xchacha_random(const unsigned char* number_only_used_once, const unsigned char* key, uint32_t range) {
+	uint32_t limit = (~uint32_t{ 0 } - (range - 1));
+	uint32_t limit_d = limit / range;
+	uint32_t limit_r = limit % range;
+
+	uint32_t sample;
+	uint64_t m;
+	uint32_t h_value;
+	uint32_t l_value;
+
+	std::array<uint32_t, (crypto_stream_xchacha20_NONCEBYTES / 4) + 1>* n = (std::array<uint32_t, (crypto_stream_xchacha20_NONCEBYTES / 4) + 1>*)number_only_used_once;
+	std::array<uint32_t, (crypto_stream_xchacha20_KEYBYTES / 4) + 1>* k = (std::array<uint32_t, (crypto_stream_xchacha20_KEYBYTES / 4) + 1>*)
+		key;
+
+	do {
+		crypto_stream_xchacha20((unsigned char*)&sample, sizeof(sample), number_only_used_once, key);
+		n->operator[](0) += 1;
+
+		m = uint64_t{ sample } *uint64_t{ range };
+		h_value = m >> 32;     // high part of m
+		l_value = uint32_t(m); // low part of m
+	} while (l_value < limit_r); // discard out of bounds 
+
+	return h_value;
+}
+
+struct minesweeper_seed_t {
+	std::array<uint32_t, (crypto_stream_xchacha20_NONCEBYTES / 4) + 1> nonce = {};
+	std::array<uint32_t, (crypto_stream_xchacha20_KEYBYTES / 4) + 1> key = {};
+};
+
+// key from the os, nonce from the clock, what the game uses
+inline minesweeper_seed_t minesweeper_random_seed() {
+	minesweeper_seed_t seed;
+	uint64_t timestamp = std::chrono::steady_clock::now().time_since_epoch().count();
+	std::memcpy(seed.nonce.data(), &timestamp, std::min(sizeof(timestamp), sizeof(seed.nonce)));
+	randombytes_buf(seed.key.data(), sizeof(seed.key));
+	return seed;
+}
+
+// reproducible boards for batch runs, the same value always deals the same games
+inline minesweeper_seed_t minesweeper_seed(uint64_t value) {
+	minesweeper_seed_t seed;
+	uint64_t state = value;
+	for (size_t i = 0; i < seed.key.size(); i++) {
+		// splitmix64
+		state += 0x9e3779b97f4a7c15;
+		uint64_t z = state;
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+		seed.key[i] = uint32_t(z ^ (z >> 31));
+	}
+	return seed;
+}
+
+// keystream a few blocks at a time, asking xchacha20 for 4 bytes per call redoes the key setup and throws
+// away the rest of the block
+struct xchacha_stream_t {
+	minesweeper_seed_t& seed;
+	std::array<uint32_t, 64> buffer = {};
+	size_t used = 64;
+};
+
+inline uint32_t xchacha_stream_next(xchacha_stream_t& stream) {
+	if (stream.used == stream.buffer.size()) {
+		crypto_stream_xchacha20((unsigned char*)stream.buffer.data(), sizeof(stream.buffer), (const unsigned char*)stream.seed.nonce.data(), (const unsigned char*)stream.seed.key.data());
+		stream.seed.nonce[0] += 1;
+		stream.used = 0;
+	}
+	return stream.buffer[stream.used++];
+}
+
+// uniform in [0, range)
+inline uint32_t xchacha_stream_random(xchacha_stream_t& stream, uint32_t range) {
+	uint32_t limit = (~uint32_t{ 0 } - (range - 1));
+	uint32_t limit_r = limit % range;
+
+	uint64_t m;
+	uint32_t l_value;
+	do {
+		m = uint64_t{ xchacha_stream_next(stream) } * uint64_t{ range };
+		l_value = uint32_t(m); // low part of m
+	} while (l_value < limit_r); // discard out of bounds
+
+	return m >> 32; // high part of m
+}
+
+inline void minesweeper_start(std::vector<mine>& tiles, uint32_t x_tiles, uint32_t y_tiles, uint64_t mine_count, minesweeper_seed_t& seed) {
+	uint64_t total_tiles = (x_tiles * y_tiles);
+
+	tiles.clear();
+	tiles.reserve(total_tiles); //largest size
+
+	if (total_tiles <= 0)
+		return;
+
+	for (size_t i = 0; i < total_tiles; i++) {
+		tiles.emplace_back();
+	}
+
+	xchacha_stream_t stream = { seed };
+
+	for (size_t i = 0; i < total_tiles; i++) {
+		tiles[i].flags = (uint16_t)mine_flag::hidden | ((uint16_t)mine_flag::mine * (i < mine_count));
+	}
+
+	if (mine_count >= total_tiles)
+		return;
+
+	// random permutation (fisher yates), each tile only swaps with the ones not placed yet so every
+	// placement of the mines is equally likely
+	for (size_t i = 0; i + 1 < total_tiles; i++) {
+		uint32_t h_value = xchacha_stream_random(stream, total_tiles - i);
+		std::swap(tiles[i], tiles[i + h_value]);
+	}
+}
+
+inline void minesweeper_start(std::vector<mine>& tiles, uint32_t x_tiles, uint32_t y_tiles, uint64_t mine_count) {
+	minesweeper_seed_t seed = minesweeper_random_seed();
+	minesweeper_start(tiles, x_tiles, y_tiles, mine_count, seed);
+}
+
+inline void minesweeper_swap_to_empty_tile(std::vector<mine>& tiles, std::vector<uint32_t>& idxs, uint32_t tile, minesweeper_seed_t& seed) {
+	idxs.clear();
+	if (tile >= tiles.size())
+		return;
+
+	if (!is_mine(tiles[tile]))
+		return;
+
+	idxs.reserve(tiles.capacity());
+	for (size_t i = 0; i < tiles.size(); i++) {
+		if (!is_mine(tiles[i]))
+			idxs.emplace_back(i);
+	}
+	// every tile is a mine, nowhere to move this one
+	if (idxs.empty())
+		return;
+
+	xchacha_stream_t stream = { seed };
+	uint32_t h_value = xchacha_stream_random(stream, idxs.size());
+
+	// h_value indexes the empty tiles, not the board. only the mine moves, flags stay where the player put them
+	tiles[tile].flags &= ~(uint16_t)mine_flag::mine;
+	tiles[idxs[h_value]].flags |= (uint16_t)mine_flag::mine;
+}
+
+inline void minesweeper_swap_to_empty_tile(std::vector<mine>& tiles, std::vector<uint32_t>& idxs, uint32_t tile) {
+	minesweeper_seed_t seed = minesweeper_random_seed();
+	minesweeper_swap_to_empty_tile(tiles, idxs, tile, seed);
+}
+
+inline void minesweeper_neighbors_2d(std::vector<mine>& tiles, uint32_t x_tiles, uint32_t y_tiles) {
+	struct offset {
+		int x = {};
+		int y = {};
+	};
+
+	std::array<offset, 8> offsets = {
+		offset{-1, -1}, offset{0, -1}, offset{1, -1},
+		offset{-1,  0},                offset{1,  0},
+		offset{-1,  1}, offset{0,  1}, offset{1,  1}
+	};
+
+	for (size_t i = 0; i < tiles.size(); i++) {
+		tiles[i].nearby = 0;
+		offset position = { i % x_tiles, i / x_tiles };
+		for (size_t o = 0; o < offsets.size(); o++) {
+			offset test_position = { position.x + offsets[o].x, position.y + offsets[o].y };
+			uint32_t test_idx = test_position.y * x_tiles + test_position.x;
+
+			bool within_grid = (test_position.x >= 0 && test_position.x < x_tiles)
+				&& (test_position.y >= 0 && test_position.y < y_tiles);
+			tiles[i].nearby += within_grid && is_mine(tiles[test_idx]);
+		}
+	}
+}
+
+// scanline flood fill
+inline void minesweeper_reveal(std::vector<mine>& tiles, std::vector<uint32_t>& idxs, uint32_t x_tiles, uint32_t y_tiles, uint32_t tile) {
+	idxs.clear();
+
+	for (size_t i = 0; i < tiles.size(); i++) {
+		tiles[i].flags |= (uint16_t)mine_flag::flood;
+	}
+
+	idxs.emplace_back(tile);
+
+	tiles[tile].flags &= ~((uint16_t)mine_flag::flood | (uint16_t)mine_flag::hidden);
+	if (is_near_mine(tiles[tile])) {
+		return;
+	}
+
+	for (size_t i = 0; i < idxs.size(); i++) {
+		tile = idxs[i];
+
+		tiles[tile].flags &= ~((uint16_t)mine_flag::flood | (uint16_t)mine_flag::hidden);
+
+		bool wall_above = true;
+		bool wall_below = true;
+
+		{
+			size_t idx_above = tile - x_tiles;
+			if (idx_above < tiles.size()) {
+				bool above_near = is_near_mine(tiles[idx_above]);
+				if (wall_above == true && !above_near && is_flooded(tiles[idx_above])) {
+					idxs.emplace_back(idx_above);
+					wall_above = false;
+				}
+				else if (above_near) {
+					wall_above = true;
+				}
+				tiles[idx_above].flags &= ~((uint16_t)mine_flag::flood | (uint16_t)mine_flag::hidden);
+			}
+
+			size_t idx_below = tile + x_tiles;
+			if (idx_below < tiles.size()) {
+				bool below_near = is_near_mine(tiles[idx_below]);
+				if (wall_below == true && !below_near && is_flooded(tiles[idx_below])) {
+					idxs.emplace_back(idx_below);
+					wall_below = false;
+				}
+				else if (below_near) {
+					wall_below = true;
+				}
+				tiles[idx_below].flags &= ~((uint16_t)mine_flag::flood | (uint16_t)mine_flag::hidden);
+			}
+		}
+
+		if (is_near_mine(tiles[tile])) { //is_hidden(tiles[idx])
+			continue;
+		}
+
+		uint32_t tile_y = tile / x_tiles;
+		for (size_t idx = tile + 1; idx < tiles.size(); idx++) {
+			{
+				uint32_t idx_y = idx / x_tiles;
+				if (idx_y != tile_y)
+					break;
+			}
+
+			size_t idx_above = idx - x_tiles;
+			if (idx_above < tiles.size()) {
+				bool above_near = is_near_mine(tiles[idx_above]);
+				if (wall_above == true && !above_near && is_flooded(tiles[idx_above])) {
+					idxs.emplace_back(idx_above);
+					wall_above = false;
+				}
+				else if (above_near) {
+
+					wall_above = true;
+				}
+				tiles[idx_above].flags &= ~((uint16_t)mine_flag::flood | (uint16_t)mine_flag::hidden);
+			}
+
+			size_t idx_below = idx + x_tiles;
+			if (idx_below < tiles.size()) {
+				bool below_near = is_near_mine(tiles[idx_below]);
+				if (wall_below == true && !below_near && is_flooded(tiles[idx_below])) {
+					idxs.emplace_back(idx_below);
+					wall_below = false;
+				}
+				else if (below_near) {
+
+					wall_below = true;
+				}
+				tiles[idx_below].flags &= ~((uint16_t)mine_flag::flood | (uint16_t)mine_flag::hidden);
+			}
+
+			tiles[idx].flags &= ~((uint16_t)mine_flag::flood | (uint16_t)mine_flag::hidden);
+			if (is_near_mine(tiles[idx])) { //is_hidden(tiles[idx])
+				break;
+			}
+		}
+
+		wall_above = true;
+		wall_below = true;
+		for (size_t idx = tile - 1; idx < tiles.size(); idx--) {
+			{
+				uint32_t idx_y = idx / x_tiles;
+				if (idx_y != tile_y)
+					break;
+			}
+
+			size_t idx_above = idx - x_tiles;
+			if (idx_above < tiles.size()) {
+				bool above_near = is_near_mine(tiles[idx_above]);
+				if (wall_above == true && !above_near && is_flooded(tiles[idx_above])) {
+					idxs.emplace_back(idx_above);
+					wall_above = false;
+				}
+				else if (above_near) {
+
+					wall_above = true;
+				}
+				tiles[idx_above].flags &= ~((uint16_t)mine_flag::flood | (uint16_t)mine_flag::hidden);
+			}
+
+			size_t idx_below = idx + x_tiles;
+			if (idx_below < tiles.size()) {
+				bool below_near = is_near_mine(tiles[idx_below]);
+				if (wall_below == true && !below_near && is_flooded(tiles[idx_below])) {
+					idxs.emplace_back(idx_below);
+					wall_below = false;
+				}
+				else if (below_near) {
+
+					wall_below = true;
+				}
+				tiles[idx_below].flags &= ~((uint16_t)mine_flag::flood | (uint16_t)mine_flag::hidden);
+			}
+
+			tiles[idx].flags &= ~((uint16_t)mine_flag::flood | (uint16_t)mine_flag::hidden);
+			if (is_near_mine(tiles[idx])) { //is_hidden(tiles[idx])
+				break;
+			}
+		}
+	}
+
+}
+
+// rows a reveal may have changed: every revealed tile sits within a row of a tile the flood fill queued
+inline void minesweeper_reveal_rows(const std::vector<uint32_t>& idxs, uint32_t x_tiles, uint32_t y_tiles, std::vector<uint32_t>& rows) {
+	rows.clear();
+	for (size_t i = 0; i < idxs.size(); i++) {
+		uint32_t y = idxs[i] / x_tiles;
+		for (uint32_t row = y ? y - 1 : 0; row <= y + 1 && row < y_tiles; row++)
+			rows.emplace_back(row);
+	}
+	std::sort(rows.begin(), rows.end());
+	rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+}
+
+inline size_t minesweeper_minimum_clicks(std::vector<mine>& copy, const std::vector<mine>& tiles, std::vector<uint32_t>& idxs, uint32_t x_tiles, uint32_t y_tiles) {
+	copy.clear();
+	copy.assign(tiles.data(), tiles.data() + tiles.size());
+
+	for (size_t i = 0; i < copy.size(); i++) {
+		copy[i].flags |= (uint16_t)mine_flag::hidden;
+	}
+	size_t count = 0;
+	
+	size_t shown = 0;
+	size_t mines_revealed = 0;
+	// search for a thing to click and click it, do big impact ones first
+	for (size_t i = 0; i < copy.size(); i++) {
+		if (!is_mine(copy[i]) && is_hidden(copy[i]) && !is_near_mine(copy[i])) {
+			minesweeper_reveal(copy, idxs, x_tiles, y_tiles, i);
+			count++;
+		}
+	}
+	// click on individiual hints
+	for (size_t i = 0; i < copy.size(); i++) {
+		if (!is_mine(copy[i]) && is_hidden(copy[i])) {
+			minesweeper_reveal(copy, idxs, x_tiles, y_tiles, i);
+			count++;
+		}
+	}
+	return count;
+}
+
+// keeps 3bv (openings + numbers no opening reveals) current while single mines move around the board.
+// a move only changes numbers next to the two tiles involved, so only the 5x5 windows around them are
+// rescored, plus whichever openings reach into those windows.
+struct minesweeper_tune_t {
+	std::vector<uint32_t> label; // opening id of zero tiles, 0 for everything else
+	std::vector<uint32_t> mines_at; // tiles holding a mine
+	std::vector<uint32_t> empty_at; // tiles without one
+	std::vector<uint32_t> slot; // index of each tile in mines_at or empty_at
+	std::vector<uint32_t> stamp; // visited marks, compared against stamp_id
+	uint32_t stamp_id = 0;
+	uint32_t next_label = 1;
+	int64_t openings = 0;
+	int64_t isolated = 0; // numbers with no zero next to them
+	int64_t openings_change = 0; // of the pending proposal
+	int64_t isolated_change = 0;
+
+	std::vector<uint32_t> window;
+	std::vector<uint32_t> labels;
+	std::vector<uint32_t> queue;
+	std::vector<uint32_t> flooded; // tiles of the openings found in the window after the move
+	std::vector<uint32_t> flooded_end; // where each of those openings ends in flooded
+};
+
+constexpr std::array<std::array<int, 2>, 8> minesweeper_offsets = { {
+	{ -1, -1 }, { 0, -1 }, { 1, -1 },
+	{ -1,  0 },            { 1,  0 },
+	{ -1,  1 }, { 0,  1 }, { 1,  1 },
+} };
+
+inline bool minesweeper_tune_zero(const std::vector<mine>& tiles, uint32_t tile) {
+	return !is_mine(tiles[tile]) && !is_near_mine(tiles[tile]);
+}
+
+inline bool minesweeper_tune_isolated(const std::vector<mine>& tiles, uint32_t x_tiles, uint32_t y_tiles, uint32_t tile) {
+	if (is_mine(tiles[tile]) || !is_near_mine(tiles[tile]))
+		return false;
+	int x = tile % x_tiles;
+	int y = tile / x_tiles;
+	for (const std::array<int, 2>& o : minesweeper_offsets) {
+		int nx = x + o[0];
+		int ny = y + o[1];
+		if (nx >= 0 && ny >= 0 && nx < (int)x_tiles && ny < (int)y_tiles && minesweeper_tune_zero(tiles, ny * x_tiles + nx))
+			return false;
+	}
+	return true;
+}
+
+inline uint32_t minesweeper_tune_stamp(minesweeper_tune_t& t) {
+	if (++t.stamp_id == 0) {
+		std::fill(t.stamp.begin(), t.stamp.end(), 0);
+		t.stamp_id = 1;
+	}
+	return t.stamp_id;
+}
+
+// every zero tile of the opening holding start goes into flooded, stamped with id
+inline void minesweeper_tune_flood(minesweeper_tune_t& t, const std::vector<mine>& tiles, uint32_t x_tiles, uint32_t y_tiles, uint32_t start, uint32_t id) {
+	size_t first = t.flooded.size();
+	t.stamp[start] = id;
+	t.flooded.emplace_back(start);
+	for (size_t i = first; i < t.flooded.size(); i++) {
+		uint32_t tile = t.flooded[i];
+		int x = tile % x_tiles;
+		int y = tile / x_tiles;
+		for (const std::array<int, 2>& o : minesweeper_offsets) {
+			int nx = x + o[0];
+			int ny = y + o[1];
+			if (nx < 0 || ny < 0 || nx >= (int)x_tiles || ny >= (int)y_tiles)
+				continue;
+			uint32_t n = ny * x_tiles + nx;
+			if (t.stamp[n] != id && minesweeper_tune_zero(tiles, n)) {
+				t.stamp[n] = id;
+				t.flooded.emplace_back(n);
+			}
+		}
+	}
+	t.flooded_end.emplace_back(t.flooded.size());
+}
+
+// tiles is a generated board, its numbers get filled in
+inline void minesweeper_tune_init(minesweeper_tune_t& t, std::vector<mine>& tiles, uint32_t x_tiles, uint32_t y_tiles) {
+	minesweeper_neighbors_2d(tiles, x_tiles, y_tiles);
+	t.label.assign(tiles.size(), 0);
+	t.stamp.assign(tiles.size(), 0);
+	t.stamp_id = 0;
+	t.slot.assign(tiles.size(), 0);
+	t.mines_at.clear();
+	t.empty_at.clear();
+	for (uint32_t i = 0; i < tiles.size(); i++) {
+		std::vector<uint32_t>& list = is_mine(tiles[i]) ? t.mines_at : t.empty_at;
+		t.slot[i] = list.size();
+		list.emplace_back(i);
+	}
+
+	t.next_label = 1;
+	t.openings = 0;
+	t.isolated = 0;
+	uint32_t id = minesweeper_tune_stamp(t);
+	for (uint32_t i = 0; i < tiles.size(); i++) {
+		t.isolated += minesweeper_tune_isolated(tiles, x_tiles, y_tiles, i);
+		if (!minesweeper_tune_zero(tiles, i) || t.stamp[i] == id)
+			continue;
+		t.flooded.clear();
+		t.flooded_end.clear();
+		minesweeper_tune_flood(t, tiles, x_tiles, y_tiles, i, id);
+		for (uint32_t tile : t.flooded)
+			t.label[tile] = t.next_label;
+		t.next_label++;
+		t.openings++;
+	}
+}
+
+inline int64_t minesweeper_tune_count(const minesweeper_tune_t& t) {
+	return t.openings + t.isolated;
+}
+
+// moves the mine on from to the empty tile to, fixing up the numbers around both
+inline void minesweeper_tune_move(std::vector<mine>& tiles, uint32_t x_tiles, uint32_t y_tiles, uint32_t from, uint32_t to) {
+	tiles[from].flags &= ~(uint16_t)mine_flag::mine;
+	tiles[to].flags |= (uint16_t)mine_flag::mine;
+	for (uint32_t pass = 0; pass < 2; pass++) {
+		uint32_t tile = pass ? to : from;
+		int x = tile % x_tiles;
+		int y = tile / x_tiles;
+		for (const std::array<int, 2>& o : minesweeper_offsets) {
+			int nx = x + o[0];
+			int ny = y + o[1];
+			if (nx >= 0 && ny >= 0 && nx < (int)x_tiles && ny < (int)y_tiles)
+				tiles[ny * x_tiles + nx].nearby += pass ? 1 : -1;
+		}
+	}
+}
+
+// 3bv change if the mine on from moved to to. the move is left applied and the opening structure after it is
+// kept in t.flooded for minesweeper_tune_accept, minesweeper_tune_reject puts the mine back.
+inline int64_t minesweeper_tune_propose(minesweeper_tune_t& t, std::vector<mine>& tiles, uint32_t x_tiles, uint32_t y_tiles, uint32_t from, uint32_t to) {
+	// 5x5 around each end, isolation of a number depends on the zeros around it
+	t.window.clear();
+	uint32_t id = minesweeper_tune_stamp(t);
+	for (uint32_t tile : { from, to }) {
+		int x = tile % x_tiles;
+		int y = tile / x_tiles;
+		for (int ny = std::max(y - 2, 0); ny <= std::min(y + 2, (int)y_tiles - 1); ny++) {
+			for (int nx = std::max(x - 2, 0); nx <= std::min(x + 2, (int)x_tiles - 1); nx++) {
+				uint32_t n = ny * x_tiles + nx;
+				if (t.stamp[n] != id) {
+					t.stamp[n] = id;
+					t.window.emplace_back(n);
+				}
+			}
+		}
+	}
+
+	// before: openings reaching into the window are known by label
+	int64_t isolated = 0;
+	t.labels.clear();
+	for (uint32_t tile : t.window) {
+		isolated -= minesweeper_tune_isolated(tiles, x_tiles, y_tiles, tile);
+		if (t.label[tile])
+			t.labels.emplace_back(t.label[tile]);
+	}
+	std::sort(t.labels.begin(), t.labels.end());
+	int64_t openings = -(int64_t)(std::unique(t.labels.begin(), t.labels.end()) - t.labels.begin());
+
+	// after: openings have to be found again, they may have merged or split
+	minesweeper_tune_move(tiles, x_tiles, y_tiles, from, to);
+	t.flooded.clear();
+	t.flooded_end.clear();
+	id = minesweeper_tune_stamp(t);
+	for (uint32_t tile : t.window) {
+		isolated += minesweeper_tune_isolated(tiles, x_tiles, y_tiles, tile);
+		if (minesweeper_tune_zero(tiles, tile) && t.stamp[tile] != id) {
+			minesweeper_tune_flood(t, tiles, x_tiles, y_tiles, tile, id);
+			openings++;
+		}
+	}
+	t.openings_change = openings;
+	t.isolated_change = isolated;
+	return openings + isolated;
+}
+
+inline void minesweeper_tune_accept(minesweeper_tune_t& t, const std::vector<mine>& tiles, uint32_t from, uint32_t to) {
+	for (uint32_t tile : t.window) {
+		if (!minesweeper_tune_zero(tiles, tile))
+			t.label[tile] = 0;
+	}
+	size_t begin = 0;
+	for (size_t end : t.flooded_end) {
+		for (size_t i = begin; i < end; i++)
+			t.label[t.flooded[i]] = t.next_label;
+		t.next_label++;
+		begin = end;
+	}
+	t.openings += t.openings_change;
+	t.isolated += t.isolated_change;
+
+	// from and to trade places between the mine and empty lists
+	uint32_t mine_slot = t.slot[from];
+	uint32_t empty_slot = t.slot[to];
+	t.mines_at[mine_slot] = to;
+	t.empty_at[empty_slot] = from;
+	t.slot[to] = mine_slot;
+	t.slot[from] = empty_slot;
+}
+
+inline void minesweeper_tune_reject(std::vector<mine>& tiles, uint32_t x_tiles, uint32_t y_tiles, uint32_t from, uint32_t to) {
+	minesweeper_tune_move(tiles, x_tiles, y_tiles, to, from);
+}
+
+// moves mines one at a time until 3bv lands in [minimum_clicks, maximum_clicks], then keeps moving them within
+// the band for mixing_steps more proposals. a mine and an empty tile picked uniformly is a symmetric proposal, so
+// inside the band every board in it is equally likely, the same boards rejection sampling would give.
+// outside the band moves that get closer are always taken and ones that drift away only sometimes.
+// returns the 3bv of the board left in tiles, which has its numbers filled in.
+inline size_t minesweeper_tune_clicks(minesweeper_tune_t& t, std::vector<mine>& tiles, uint32_t x_tiles, uint32_t y_tiles, size_t minimum_clicks, size_t maximum_clicks, minesweeper_seed_t& seed, size_t mixing_steps = 0, size_t max_steps = 1000000) {
+	minesweeper_tune_init(t, tiles, x_tiles, y_tiles);
+	if (t.mines_at.empty() || t.empty_at.empty())
+		return minesweeper_tune_count(t);
+
+	int64_t lo = std::min<size_t>(minimum_clicks, INT64_MAX);
+	int64_t hi = std::min<size_t>(maximum_clicks, INT64_MAX);
+	auto distance = [&](int64_t clicks) -> int64_t {
+		return clicks < lo ? lo - clicks : (clicks > hi ? clicks - hi : 0);
+	};
+	constexpr double beta = 2.0;
+	xchacha_stream_t stream = { seed };
+	size_t mixed = 0;
+	for (size_t step = 0; step < max_steps && mixed < mixing_steps + 1; step++) {
+		int64_t current = distance(minesweeper_tune_count(t));
+		if (!current) {
+			if (mixed++ == mixing_steps)
+				break;
+		}
+		uint32_t from = t.mines_at[xchacha_stream_random(stream, t.mines_at.size())];
+		uint32_t to = t.empty_at[xchacha_stream_random(stream, t.empty_at.size())];
+		int64_t delta = minesweeper_tune_propose(t, tiles, x_tiles, y_tiles, from, to);
+		int64_t change = distance(minesweeper_tune_count(t) + delta) - current;
+
+		bool accept = change <= 0;
+		if (!accept && current)
+			accept = xchacha_stream_next(stream) * (1.0 / 4294967296.0) < std::exp(-beta * change);
+		if (accept)
+			minesweeper_tune_accept(t, tiles, from, to);
+		else
+			minesweeper_tune_reject(tiles, x_tiles, y_tiles, from, to);
+	}
+	return minesweeper_tune_count(t);
+}
+
+// a board with at least minimum_clicks 3bv (and at most maximum_clicks), numbers filled in
+inline size_t minesweeper_start_with_minimum_clicks(std::vector<mine>& tiles, uint32_t x_tiles, uint32_t y_tiles, uint64_t mine_count, size_t minimum_clicks = 3, size_t maximum_clicks = ~size_t{ 0 }) {
+	minesweeper_tune_t t;
+	minesweeper_seed_t seed = minesweeper_random_seed();
+	minesweeper_start(tiles, x_tiles, y_tiles, mine_count, seed);
+	return minesweeper_tune_clicks(t, tiles, x_tiles, y_tiles, minimum_clicks, maximum_clicks, seed, tiles.size());
+}
@@ -0,0 +1,381 @@
+﻿// minesweeper_app.h : the game as one struct and the imgui frame that plays it, shared by the window in
+// imgui_template.cpp and the offscreen render benchmark. the caller owns the context, NewFrame, Render and the
+// backend, so the same frame runs under glfw or with scripted input and no window at all.
+
+#pragma once
+
+#include "imgui/imgui.h"
+#include "imgui/imgui_impl_opengl3.h"
+#include "minesweeper.h"
+#include "minesweeper_hash.h"
+#include "minesweeper_hint.h"
+#include "minesweeper_mesh.h"
+#include "minesweeper_gl.h"
+#include "minesweeper_camera.h"
+#include "minesweeper_minimap.h"
+#include "minesweeper_profile.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+struct minesweeper_app_t {
+	// custom boards, anything past a hundred or so tiles a side needs the camera to be playable
+	static constexpr uint32_t x_tiles_max = 10000;
+	static constexpr uint32_t y_tiles_max = 10000;
+	// big boards are drawn by a shader from a texture of the board instead of the mesh
+	static constexpr size_t gl_min_tiles = 64 * 64;
+
+	std::vector<mine> tiles;
+	std::vector<uint32_t> idxs;
+
+	uint64_t wins = { 0 };
+	uint64_t tries = { 0 };
+	uint64_t losses = { 0 };
+
+	uint32_t x_tiles = 9;
+	uint32_t y_tiles = 9;
+	uint32_t mines = 10;
+	size_t clicks_required = 0;
+	bool first_click = true;
+
+	// hash of what the player sees, kept up to date on every reveal and flag
+	minesweeper_zobrist_t zobrist;
+	std::vector<uint32_t> dirty_rows;
+
+	// press H to toggle hints, the solver runs on its own thread and never holds up a frame
+	minesweeper_hint_engine_t hint_engine;
+	bool show_hint = false;
+	uint64_t hint_hash = 0;
+	// every snapshot copies the whole board on the frame thread, past this many tiles hints are off
+	size_t hint_max_tiles = size_t{ 1 } << 20;
+	ImU32 hint_safe = ImU32{ 0xff2ec22e };
+	ImU32 hint_guess = ImU32{ 0xff22b8f0 };
+
+	minesweeper_palette_t palette;
+
+	// tile quads and grid lines are built once and recolored as tiles change
+	minesweeper_mesh_t mesh;
+	minesweeper_digits_t digits;
+
+	// G swaps the mesh and the shader to compare them
+	minesweeper_gl_t gl;
+	bool swap_renderer = false;
+	bool use_gl = false;
+
+	// zoomed out past a few pixels a tile the board is one image, kept current whichever renderer is up
+	minesweeper_minimap_t minimap;
+
+	// wheel zooms around the mouse, middle drag or the arrow keys pan, F fits the whole board again
+	minesweeper_camera_t camera;
+	int custom_x = 500;
+	int custom_y = 500;
+	int custom_mines = 40000;
+
+	// the outcome only changes when tiles are revealed or a new board starts, not worth a scan every frame
+	bool recount = true;
+	size_t shown = 0;
+	size_t mines_revealed = 0;
+
+	bool has_won = false;
+	bool has_lost = false;
+
+	// R toggles redrawing every frame, held keys and drags keep the window awake while they last
+	bool redraw_always = false;
+	bool animating = false;
+
+	// P shows where the frame time goes
+	minesweeper_profile_t profile;
+
+	// the backend streams each frame through a fenced ring of buffers instead of reuploading per draw list,
+	// U toggles it to compare render draw data in the overlay. off where the driver can't do it
+	bool buffer_ring = false;
+};
+
+// a new board, no 3bv tuning when min_clicks is 0, on the biggest boards it would take longer than playing
+inline void minesweeper_app_new_board(minesweeper_app_t& app, uint32_t x_tiles, uint32_t y_tiles, uint32_t mines, size_t min_clicks) {
+	app.first_click = true;
+	app.x_tiles = x_tiles;
+	app.y_tiles = y_tiles;
+	app.mines = mines;
+	if (min_clicks)
+		app.clicks_required = minesweeper_start_with_minimum_clicks(app.tiles, x_tiles, y_tiles, mines, min_clicks);
+	else {
+		minesweeper_start(app.tiles, x_tiles, y_tiles, mines);
+		minesweeper_neighbors_2d(app.tiles, x_tiles, y_tiles);
+		app.clicks_required = 0;
+	}
+	minesweeper_zobrist_reset(app.zobrist, app.tiles);
+	minesweeper_mesh_invalidate(app.mesh);
+	minesweeper_gl_invalidate(app.gl);
+	minesweeper_minimap_invalidate(app.minimap);
+	app.camera.fit = true;
+	app.recount = true;
+}
+
+// needs the gl context current and the opengl3 backend initialized
+inline void minesweeper_app_init(minesweeper_app_t& app, const char* glsl_version) {
+	minesweeper_gl_init(app.gl, glsl_version);
+	minesweeper_minimap_init(app.minimap);
+	app.buffer_ring = ImGui_ImplOpenGL3_SetBufferRing(true);
+	minesweeper_app_new_board(app, 9, 9, 10, 3);
+}
+
+inline void minesweeper_app_shutdown(minesweeper_app_t& app) {
+	// nothing left to wake once the window is gone
+	minesweeper_hint_cancel(app.hint_engine);
+	minesweeper_gl_shutdown(app.gl);
+	minesweeper_minimap_shutdown(app.minimap);
+}
+
+// the board window and the timing overlay, between NewFrame and Render. the timer is in the update phase on
+// entry and in the overlay phase on return
+inline void minesweeper_app_frame(minesweeper_app_t& app, minesweeper_frame_timer_t& timer, ImVec2 view_size) {
+	// a new board from the popup changes these halfway through
+	const uint32_t& x_tiles = app.x_tiles;
+	const uint32_t& y_tiles = app.y_tiles;
+	std::vector<mine>& tiles = app.tiles;
+	minesweeper_camera_t& camera = app.camera;
+
+	ImGui::SetNextWindowSize(view_size); // ensures ImGui fits the GLFW window
+
+	// the mesh has a quad per visible tile, it can only zoom out as far as the shader if the minimap takes over
+	bool zoom_out = app.use_gl || minesweeper_minimap_fits(app.minimap, x_tiles, y_tiles);
+	float min_tile = std::max(minesweeper_camera_fit_tile(x_tiles, y_tiles, view_size), zoom_out ? 0.0f : minesweeper_mesh_min_tile);
+	if (camera.fit)
+		minesweeper_camera_fit(camera, x_tiles, y_tiles, ImVec2{ 0.0f, 0.0f }, view_size, min_tile);
+	else if (camera.tile_dim < min_tile)
+		minesweeper_camera_zoom(camera, ImVec2{ view_size.x * 0.5f, view_size.y * 0.5f }, 1.0f, min_tile);
+
+	ImGui::SetNextWindowPos(ImVec2(0, 0));
+	{
+		ImGui::Begin("minesweeper", nullptr, ImGuiWindowFlags_::ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_::ImGuiWindowFlags_NoMove |
+			ImGuiWindowFlags_::ImGuiWindowFlags_NoCollapse
+		);
+
+		ImVec2 mouse = ImGui::GetMousePos();
+
+		bool ok_mouse = ImGui::IsMousePosValid(&mouse);
+
+		// the popup keeps the board from being hovered, so it also stops the camera
+		ImGuiIO& io = ImGui::GetIO();
+		if (ImGui::IsWindowHovered()) {
+			if (ok_mouse && io.MouseWheel != 0.0f)
+				minesweeper_camera_zoom(camera, mouse, std::pow(1.25f, io.MouseWheel), min_tile);
+			if (ImGui::IsMouseDragging(ImGuiMouseButton_::ImGuiMouseButton_Middle, 0.0f))
+				minesweeper_camera_pan(camera, io.MouseDelta);
+		}
+		// the first frame after a long wait has a long delta time
+		float scroll = 800.0f * std::min(io.DeltaTime, 1.0f / 30.0f);
+		ImVec2 arrows = {
+			scroll * (ImGui::IsKeyDown(ImGuiKey_LeftArrow) - ImGui::IsKeyDown(ImGuiKey_RightArrow)),
+			scroll * (ImGui::IsKeyDown(ImGuiKey_UpArrow) - ImGui::IsKeyDown(ImGuiKey_DownArrow)),
+		};
+		if (arrows.x != 0.0f || arrows.y != 0.0f)
+			minesweeper_camera_pan(camera, arrows);
+		app.animating = arrows.x != 0.0f || arrows.y != 0.0f || ImGui::IsMouseDragging(ImGuiMouseButton_::ImGuiMouseButton_Middle, 0.0f);
+		if (ImGui::IsKeyPressed(ImGuiKey_F, false))
+			minesweeper_camera_fit(camera, x_tiles, y_tiles, ImVec2{ 0.0f, 0.0f }, view_size, min_tile);
+		else if (!camera.fit)
+			minesweeper_camera_clamp(camera, x_tiles, y_tiles, ImVec2{ 0.0f, 0.0f }, view_size);
+
+		float tile_dim = camera.tile_dim;
+		float line_width = tile_dim / 20.0f;
+
+		ImVec2 grid_top_left = camera.origin;
+		ImVec2 grid_btm_right = minesweeper_camera_board_max(camera, x_tiles, y_tiles);
+		bool mouse_in_grid = ImGui::IsMouseHoveringRect(grid_top_left, grid_btm_right);
+
+		bool left_clicked = ok_mouse && mouse_in_grid && ImGui::IsMouseClicked(ImGuiMouseButton_::ImGuiMouseButton_Left);
+
+		bool right_clicked = ok_mouse && mouse_in_grid && ImGui::IsMouseClicked(ImGuiMouseButton_::ImGuiMouseButton_Right);
+
+		if (ImGui::IsKeyPressed(ImGuiKey_H, false)) {
+			app.show_hint = !app.show_hint;
+			app.hint_hash = 0;
+			if (!app.show_hint)
+				minesweeper_hint_cancel(app.hint_engine);
+		}
+
+		if (ImGui::IsKeyPressed(ImGuiKey_G, false))
+			app.swap_renderer = !app.swap_renderer;
+
+		if (ImGui::IsKeyPressed(ImGuiKey_R, false))
+			app.redraw_always = !app.redraw_always;
+
+		if (ImGui::IsKeyPressed(ImGuiKey_P, false))
+			app.profile.show = !app.profile.show;
+
+		if (ImGui::IsKeyPressed(ImGuiKey_U, false))
+			app.buffer_ring = ImGui_ImplOpenGL3_SetBufferRing(!app.buffer_ring);
+
+		// whichever renderer takes over starts from a full rebuild
+		bool board_gl = minesweeper_gl_fits(app.gl, x_tiles, y_tiles) && ((tiles.size() >= minesweeper_app_t::gl_min_tiles) != app.swap_renderer);
+		if (board_gl != app.use_gl) {
+			app.use_gl = board_gl;
+			minesweeper_mesh_invalidate(app.mesh);
+			minesweeper_gl_invalidate(app.gl);
+		}
+
+		// whatever the worker is doing is about to be out of date
+		if (app.show_hint && (left_clicked || right_clicked)) {
+			minesweeper_hint_cancel(app.hint_engine);
+			app.hint_hash = 0;
+		}
+
+		ImDrawList* draw_list = ImGui::GetWindowDrawList();
+		// the tile under the mouse comes from its position instead of testing every tile,
+		// one hover test over the whole board still respects the window clip rect
+		uint32_t hovered = ~uint32_t{ 0 };
+		if (ok_mouse && mouse_in_grid)
+			hovered = minesweeper_camera_tile(camera, mouse, x_tiles, y_tiles);
+
+		if (hovered < tiles.size()) {
+			uint32_t i = hovered;
+			uint16_t& flags = tiles[i].flags;
+			if (right_clicked && (flags & (uint16_t)mine_flag::hidden)) {
+				flags ^= (uint16_t)mine_flag::flagged;
+				minesweeper_zobrist_update(app.zobrist, tiles, i);
+				minesweeper_minimap_touch(app.minimap, i);
+				if (app.use_gl)
+					minesweeper_gl_touch(app.gl, i);
+				else
+					minesweeper_mesh_touch(app.mesh, i);
+			}
+
+			if (app.first_click && left_clicked) {
+				app.first_click = false;
+
+				minesweeper_swap_to_empty_tile(tiles, app.idxs, i);
+				minesweeper_neighbors_2d(tiles, x_tiles, y_tiles);
+			}
+
+			if (left_clicked && is_hidden(tiles[i]) && !is_flagged(tiles[i])) {
+				minesweeper_reveal(tiles, app.idxs, x_tiles, y_tiles, i);
+				app.recount = true;
+				minesweeper_zobrist_update_reveal(app.zobrist, tiles, app.idxs, app.dirty_rows, x_tiles, y_tiles);
+				minesweeper_minimap_touch_rows(app.minimap, app.dirty_rows);
+				if (app.use_gl)
+					minesweeper_gl_touch_rows(app.gl, app.dirty_rows);
+				else
+					minesweeper_mesh_touch_rows(app.mesh, app.dirty_rows);
+			}
+		}
+
+		timer.next(frame_phase::draw);
+		minesweeper_minimap_update(app.minimap, tiles, app.palette, x_tiles, y_tiles);
+		// same font and size AddText would pick
+		minesweeper_digits_update(app.digits, ImGui::GetFont(), ImGui::GetFontSize());
+		bool use_minimap = minesweeper_minimap_fits(app.minimap, x_tiles, y_tiles) && tile_dim < minesweeper_minimap_max_tile;
+		if (use_minimap) {
+			// the others catch up on their own touches when zoomed back in
+			minesweeper_minimap_draw(draw_list, app.minimap, tiles, app.palette, camera, hovered);
+		}
+		else if (app.use_gl) {
+			minesweeper_gl_update(app.gl, tiles, app.palette, app.digits, x_tiles, y_tiles, tile_dim, camera.origin, line_width, hovered);
+			minesweeper_gl_draw(draw_list, app.gl);
+		}
+		else {
+			// only the rows and columns inside the window clip rect are walked
+			ImVec2 clip_min = draw_list->GetClipRectMin();
+			ImVec2 clip_max = draw_list->GetClipRectMax();
+			minesweeper_tile_range_t visible = minesweeper_camera_visible(camera, ImVec4{ clip_min.x, clip_min.y, clip_max.x, clip_max.y }, x_tiles, y_tiles);
+			minesweeper_mesh_update(app.mesh, tiles, app.palette, x_tiles, y_tiles, visible, tile_dim, camera.origin, line_width, hovered);
+			minesweeper_mesh_draw_tiles(draw_list, app.mesh);
+			minesweeper_digits_draw(draw_list, app.digits, tiles, app.mesh.numbers, x_tiles, tile_dim, camera.origin, ImU32{ 0xffffffff });
+		}
+
+		timer.next(frame_phase::scan);
+		if (app.recount) {
+			app.recount = false;
+			app.shown = 0;
+			app.mines_revealed = 0;
+			for (size_t i = 0; i < tiles.size(); i++) {
+				app.shown += !is_hidden(tiles[i]) && !is_mine(tiles[i]);
+				app.mines_revealed += !is_hidden(tiles[i]) && is_mine(tiles[i]);
+			}
+		}
+
+		app.has_lost = app.mines_revealed > 0;
+		app.has_won = !app.has_lost && ((tiles.size() - app.shown) == app.mines);
+		// hint snapshots and new boards from the popup
+		timer.next(frame_phase::update);
+
+		bool hint_fits = tiles.size() <= app.hint_max_tiles;
+		if (app.show_hint && hint_fits && !app.has_won && !app.has_lost && app.zobrist.hash != app.hint_hash) {
+			minesweeper_hint_submit(app.hint_engine, tiles, x_tiles, y_tiles, app.mines, app.zobrist.hash);
+			app.hint_hash = app.zobrist.hash;
+		}
+
+		if (app.has_won || app.has_lost) {
+			const char* text = app.has_won ? "You Won!" : "You Lost!";
+			ImGui::OpenPopup(text);
+			if (ImGui::BeginPopupModal(text)) {
+				// a new board from any button ends this game
+				auto finish = [&]() {
+					app.losses += app.has_lost;
+					app.wins += app.has_won;
+					app.tries++;
+				};
+				if (ImGui::Button("Easy")) {
+					finish();
+					minesweeper_app_new_board(app, 9, 9, 10, 3);
+				}
+				else if (ImGui::Button("Intermediate")) {
+					finish();
+					minesweeper_app_new_board(app, 16, 16, 40, 6);
+				}
+				else if (ImGui::Button("Expert")) {
+					finish();
+					minesweeper_app_new_board(app, 30, 16, 99, 9);
+				}
+
+				ImGui::InputInt("width", &app.custom_x);
+				ImGui::InputInt("height", &app.custom_y);
+				ImGui::InputInt("mines", &app.custom_mines);
+				app.custom_x = std::clamp<int>(app.custom_x, 2, minesweeper_app_t::x_tiles_max);
+				app.custom_y = std::clamp<int>(app.custom_y, 2, minesweeper_app_t::y_tiles_max);
+				app.custom_mines = std::clamp<int>(app.custom_mines, 1, app.custom_x * app.custom_y - 1);
+				if (ImGui::Button("Custom")) {
+					finish();
+					minesweeper_app_new_board(app, app.custom_x, app.custom_y, app.custom_mines, 0);
+				}
+				ImGui::EndPopup();
+			}
+		}
+
+		timer.next(frame_phase::draw);
+		// draw lines, the shader already did and the minimap has none
+		if (!app.use_gl && !use_minimap)
+			minesweeper_mesh_draw_lines(draw_list, app.mesh);
+
+		if (app.show_hint) {
+			minesweeper_hint_t hint = minesweeper_hint_current(app.hint_engine);
+			if (hint.kind != hint_kind::none && hint.tile < tiles.size()) {
+				ImVec2 top_left = { camera.origin.x + (float)(hint.tile % x_tiles) * tile_dim, camera.origin.y + (float)(hint.tile / x_tiles) * tile_dim };
+				ImVec2 btm_right = { top_left.x + tile_dim, top_left.y + tile_dim };
+				draw_list->AddRect(top_left, btm_right, hint.kind == hint_kind::safe ? app.hint_safe : app.hint_guess, 0.0f, 0, line_width * 3.0f);
+			}
+			if (!hint_fits) {
+				ImVec2 at = ImGui::GetWindowPos();
+				char text[64];
+				std::snprintf(text, sizeof(text), "no hints above %zu tiles", app.hint_max_tiles);
+				draw_list->AddText(ImVec2{ at.x + 8.0f, at.y + 8.0f }, app.hint_guess, text);
+			}
+		}
+
+		ImGui::End();
+	}
+
+	timer.next(frame_phase::overlay);
+	minesweeper_profile_overlay(app.profile);
+	// the hint engine's transposition table, appended to the timing window
+	if (app.profile.show) {
+		minesweeper_transposition_stats_t table = minesweeper_transposition_stats(app.hint_engine.table);
+		if (ImGui::Begin("frame timing")) {
+			ImGui::Separator();
+			ImGui::Text("hint table: %llu probes, %llu hits, %llu stores, %.1f%% hit rate", (unsigned long long)table.probes, (unsigned long long)table.hits,
+				(unsigned long long)table.stores, 100.0 * table.hit_rate);
+		}
+		ImGui::End();
+	}
+}
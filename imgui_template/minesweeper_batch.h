@@ -0,0 +1,281 @@
+﻿// minesweeper_batch.h : many same size games stepped in lockstep. every plane keeps one bit per game, so
+// reveal, flood fill, flagging and win / loss checks are word wide operations across 64 games at a time.
+
+#pragma once
+
+#include "minesweeper.h"
+
+enum class batch_action : uint8_t {
+	none = 0,
+	reveal = 1,
+	flag = 2, // toggles the flag
+};
+
+struct minesweeper_batch_action_t {
+	uint32_t tile = 0;
+	batch_action kind = batch_action::none;
+};
+
+// planes are indexed [tile * words + game / 64], bit game % 64
+struct minesweeper_batch_t {
+	uint32_t x_tiles = 0;
+	uint32_t y_tiles = 0;
+	uint64_t mine_count = 0;
+	uint32_t games = 0;
+	uint32_t words = 0;
+
+	std::vector<uint64_t> mines;
+	std::vector<uint64_t> hidden;
+	std::vector<uint64_t> flagged;
+	std::array<std::vector<uint64_t>, 4> nearby; // bit sliced 0 - 8 count
+	std::vector<uint64_t> zero; // safe tiles with nothing nearby, where the flood fill spreads
+	std::vector<uint64_t> front; // zero tiles opened in the last flood step
+	std::vector<uint64_t> next;
+
+	// one bit per game, [game / 64]
+	std::vector<uint64_t> started; // first reveal done, it can no longer hit a mine
+	std::vector<uint64_t> lost;
+	std::vector<uint64_t> won;
+
+	std::vector<uint32_t> neighbors; // [tile * 8 + i], neighbor_count[tile] of them valid
+	std::vector<uint8_t> neighbor_count;
+	std::vector<minesweeper_seed_t> seeds; // per game, for boards and the first click swap
+	std::vector<mine> scratch;
+	std::vector<uint8_t> stale; // per word, mines moved since the counts were taken
+};
+
+inline uint64_t& minesweeper_batch_word(std::vector<uint64_t>& plane, const minesweeper_batch_t& b, uint32_t tile, uint32_t game) {
+	return plane[size_t{ tile } * b.words + game / 64];
+}
+
+inline bool minesweeper_batch_bit(const std::vector<uint64_t>& plane, const minesweeper_batch_t& b, uint32_t tile, uint32_t game) {
+	return (plane[size_t{ tile } * b.words + game / 64] >> (game % 64)) & 1;
+}
+
+inline uint8_t minesweeper_batch_nearby(const minesweeper_batch_t& b, uint32_t tile, uint32_t game) {
+	uint8_t count = 0;
+	for (uint32_t i = 0; i < b.nearby.size(); i++)
+		count |= minesweeper_batch_bit(b.nearby[i], b, tile, game) << i;
+	return count;
+}
+
+// false when no board of this size has a safe tile, the first click would have nowhere to move its mine
+inline bool minesweeper_batch_init(minesweeper_batch_t& b, uint32_t games, uint32_t x_tiles, uint32_t y_tiles, uint64_t mine_count) {
+	if (mine_count >= uint64_t{ x_tiles } * y_tiles)
+		return false;
+	b.x_tiles = x_tiles;
+	b.y_tiles = y_tiles;
+	b.mine_count = mine_count;
+	b.games = games;
+	b.words = (games + 63) / 64;
+
+	size_t tile_count = size_t{ x_tiles } * y_tiles;
+	size_t plane_size = tile_count * b.words;
+	b.mines.assign(plane_size, 0);
+	b.hidden.assign(plane_size, 0);
+	b.flagged.assign(plane_size, 0);
+	for (std::vector<uint64_t>& plane : b.nearby)
+		plane.assign(plane_size, 0);
+	b.zero.assign(plane_size, 0);
+	b.front.assign(plane_size, 0);
+	b.next.assign(plane_size, 0);
+	b.started.assign(b.words, 0);
+	b.lost.assign(b.words, 0);
+	b.won.assign(b.words, 0);
+	b.stale.assign(b.words, 0);
+	b.seeds.resize(games);
+
+	b.neighbors.assign(tile_count * 8, 0);
+	b.neighbor_count.assign(tile_count, 0);
+	for (uint32_t tile = 0; tile < tile_count; tile++) {
+		int x = tile % x_tiles;
+		int y = tile / x_tiles;
+		for (int dy = -1; dy <= 1; dy++) {
+			for (int dx = -1; dx <= 1; dx++) {
+				int nx = x + dx;
+				int ny = y + dy;
+				if ((dx || dy) && nx >= 0 && ny >= 0 && nx < (int)x_tiles && ny < (int)y_tiles)
+					b.neighbors[tile * 8 + b.neighbor_count[tile]++] = ny * x_tiles + nx;
+			}
+		}
+	}
+	return true;
+}
+
+// bit sliced neighbor counts for one word of games, 64 boards counted per pass
+inline void minesweeper_batch_count(minesweeper_batch_t& b, uint32_t word) {
+	size_t tile_count = size_t{ b.x_tiles } * b.y_tiles;
+	for (size_t tile = 0; tile < tile_count; tile++) {
+		uint64_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+		for (uint32_t i = 0; i < b.neighbor_count[tile]; i++) {
+			uint64_t bit = b.mines[size_t{ b.neighbors[tile * 8 + i] } * b.words + word];
+			uint64_t carry = c0 & bit;
+			c0 ^= bit;
+			uint64_t t = c1 & carry;
+			c1 ^= carry;
+			carry = t;
+			t = c2 & carry;
+			c2 ^= carry;
+			c3 |= t;
+		}
+		size_t at = tile * b.words + word;
+		b.nearby[0][at] = c0;
+		b.nearby[1][at] = c1;
+		b.nearby[2][at] = c2;
+		b.nearby[3][at] = c3;
+		b.zero[at] = ~(b.mines[at] | c0 | c1 | c2 | c3);
+	}
+}
+
+// deals a new board to one game, the same seed always deals the same board
+inline void minesweeper_batch_reset(minesweeper_batch_t& b, uint32_t game, uint64_t seed) {
+	b.seeds[game] = minesweeper_seed(seed);
+	minesweeper_start(b.scratch, b.x_tiles, b.y_tiles, b.mine_count, b.seeds[game]);
+
+	uint32_t word = game / 64;
+	uint64_t bit = uint64_t{ 1 } << (game % 64);
+	for (size_t tile = 0; tile < b.scratch.size(); tile++) {
+		size_t at = tile * b.words + word;
+		b.mines[at] = is_mine(b.scratch[tile]) ? (b.mines[at] | bit) : (b.mines[at] & ~bit);
+		b.hidden[at] |= bit;
+		b.flagged[at] &= ~bit;
+	}
+	b.started[word] &= ~bit;
+	b.lost[word] &= ~bit;
+	b.won[word] &= ~bit;
+	// counted once per word at the next step, however many of its games were reset
+	b.stale[word] = 1;
+}
+
+// seeds holds one seed per game
+inline void minesweeper_batch_reset_all(minesweeper_batch_t& b, const uint64_t* seeds) {
+	for (uint32_t game = 0; game < b.games; game++) {
+		b.seeds[game] = minesweeper_seed(seeds[game]);
+		minesweeper_start(b.scratch, b.x_tiles, b.y_tiles, b.mine_count, b.seeds[game]);
+		uint32_t word = game / 64;
+		uint64_t bit = uint64_t{ 1 } << (game % 64);
+		for (size_t tile = 0; tile < b.scratch.size(); tile++) {
+			size_t at = tile * b.words + word;
+			b.mines[at] = is_mine(b.scratch[tile]) ? (b.mines[at] | bit) : (b.mines[at] & ~bit);
+		}
+	}
+	std::fill(b.hidden.begin(), b.hidden.end(), ~uint64_t{ 0 });
+	std::fill(b.flagged.begin(), b.flagged.end(), 0);
+	std::fill(b.started.begin(), b.started.end(), 0);
+	std::fill(b.lost.begin(), b.lost.end(), 0);
+	std::fill(b.won.begin(), b.won.end(), 0);
+	for (uint32_t word = 0; word < b.words; word++)
+		minesweeper_batch_count(b, word);
+	std::fill(b.stale.begin(), b.stale.end(), 0);
+}
+
+// same as minesweeper_swap_to_empty_tile, the mine under a first click moves to a random safe tile
+inline void minesweeper_batch_swap_to_empty_tile(minesweeper_batch_t& b, uint32_t game, uint32_t tile) {
+	uint32_t word = game / 64;
+	uint64_t bit = uint64_t{ 1 } << (game % 64);
+	size_t tile_count = size_t{ b.x_tiles } * b.y_tiles;
+	if (tile_count <= b.mine_count)
+		return;
+	uint32_t empty = tile_count - b.mine_count;
+	xchacha_stream_t stream = { b.seeds[game] };
+	uint32_t pick = xchacha_stream_random(stream, empty);
+	for (size_t i = 0; i < tile_count; i++) {
+		if (b.mines[i * b.words + word] & bit)
+			continue;
+		if (!pick--) {
+			b.mines[i * b.words + word] |= bit;
+			break;
+		}
+	}
+	b.mines[size_t{ tile } * b.words + word] &= ~bit;
+}
+
+// one action per game (actions[game]), games that are already won or lost ignore theirs.
+// afterwards won / lost hold every finished game.
+inline void minesweeper_batch_step(minesweeper_batch_t& b, const minesweeper_batch_action_t* actions) {
+	size_t tile_count = size_t{ b.x_tiles } * b.y_tiles;
+
+	// first clicks on a mine are rare, fix those boards up before anything is revealed
+	for (uint32_t game = 0; game < b.games; game++) {
+		uint32_t word = game / 64;
+		uint64_t bit = uint64_t{ 1 } << (game % 64);
+		const minesweeper_batch_action_t& a = actions[game];
+		if (a.kind != batch_action::reveal || a.tile >= tile_count || ((b.lost[word] | b.won[word]) & bit))
+			continue;
+		if (b.flagged[size_t{ a.tile } * b.words + word] & bit)
+			continue;
+		if (!(b.started[word] & bit)) {
+			b.started[word] |= bit;
+			if (b.mines[size_t{ a.tile } * b.words + word] & bit) {
+				minesweeper_batch_swap_to_empty_tile(b, game, a.tile);
+				b.stale[word] = 1;
+			}
+		}
+	}
+	for (uint32_t word = 0; word < b.words; word++) {
+		if (b.stale[word])
+			minesweeper_batch_count(b, word);
+		b.stale[word] = 0;
+	}
+
+	// scatter the actions into the front plane (reveals) and straight into the flags
+	bool flooding = false;
+	for (uint32_t game = 0; game < b.games; game++) {
+		uint32_t word = game / 64;
+		uint64_t bit = uint64_t{ 1 } << (game % 64);
+		const minesweeper_batch_action_t& a = actions[game];
+		if (a.kind == batch_action::none || a.tile >= tile_count || ((b.lost[word] | b.won[word]) & bit))
+			continue;
+		size_t at = size_t{ a.tile } * b.words + word;
+		if (a.kind == batch_action::flag) {
+			b.flagged[at] ^= bit & b.hidden[at];
+			continue;
+		}
+		uint64_t open = bit & b.hidden[at] & ~b.flagged[at];
+		b.lost[word] |= open & b.mines[at];
+		b.hidden[at] &= ~open;
+		b.front[at] |= open & b.zero[at];
+		flooding |= (open & b.zero[at]) != 0;
+	}
+
+	// breadth first flood fill, every game advances one ring per pass
+	while (flooding) {
+		flooding = false;
+		for (size_t tile = 0; tile < tile_count; tile++) {
+			uint64_t* front = &b.front[tile * b.words];
+			uint64_t any = 0;
+			for (uint32_t w = 0; w < b.words; w++)
+				any |= front[w];
+			if (!any)
+				continue;
+			for (uint32_t i = 0; i < b.neighbor_count[tile]; i++) {
+				size_t n = size_t{ b.neighbors[tile * 8 + i] } * b.words;
+				uint64_t* hidden = &b.hidden[n];
+				uint64_t* zero = &b.zero[n];
+				uint64_t* next = &b.next[n];
+				for (uint32_t w = 0; w < b.words; w++) {
+					uint64_t open = front[w] & hidden[w];
+					hidden[w] &= ~open;
+					next[w] |= open & zero[w];
+				}
+			}
+		}
+		for (size_t i = 0; i < b.front.size(); i++) {
+			b.front[i] = b.next[i];
+			flooding |= b.next[i] != 0;
+			b.next[i] = 0;
+		}
+	}
+
+	// won once no safe tile is hidden
+	std::vector<uint64_t>& pending = b.next; // all zero here, borrowed for the reduction
+	for (size_t tile = 0; tile < tile_count; tile++) {
+		for (uint32_t w = 0; w < b.words; w++)
+			pending[w] |= b.hidden[tile * b.words + w] & ~b.mines[tile * b.words + w];
+	}
+	for (uint32_t w = 0; w < b.words; w++) {
+		uint64_t valid = (w + 1) * 64 <= b.games ? ~uint64_t{ 0 } : (uint64_t{ 1 } << (b.games % 64)) - 1;
+		b.won[w] = ~pending[w] & ~b.lost[w] & valid;
+		pending[w] = 0;
+	}
+}
@@ -0,0 +1,203 @@
+﻿// minesweeper_batch_check.cpp : plays the same seeded games through minesweeper_batch_t and through the scalar
+// board functions the game uses, then compares every plane after every step. exits 1 on any mismatch.
+//
+
+#include "minesweeper_batch.h"
+#include "minesweeper_simulate.h"
+#include <cstdio>
+
+// one game on the scalar side, with the bits the batch keeps per game
+struct check_game_t {
+	std::vector<mine> tiles;
+	minesweeper_seed_t seed;
+	chacha8r rng = chacha8r(0, 0);
+	uint32_t boards = 0; // dealt so far
+	bool started = false;
+	bool lost = false;
+	bool won = false;
+};
+
+static void check_deal(check_game_t& g, const simulate_difficulty_t& d, uint64_t seed) {
+	g.seed = minesweeper_seed(seed);
+	minesweeper_start(g.tiles, d.x_tiles, d.y_tiles, d.mine_count, g.seed);
+	minesweeper_neighbors_2d(g.tiles, d.x_tiles, d.y_tiles);
+	g.boards++;
+	g.started = false;
+	g.lost = false;
+	g.won = false;
+}
+
+// a random hidden tile, flags now and then so flagged tiles get clicked and unflagged too. picks holds the
+// unflagged tiles first, with every hidden tile flagged the only move left is a flag
+static minesweeper_batch_action_t check_pick(check_game_t& g, std::vector<uint32_t>& picks) {
+	picks.clear();
+	for (uint32_t i = 0; i < g.tiles.size(); i++) {
+		if (is_hidden(g.tiles[i]) && !is_flagged(g.tiles[i]))
+			picks.emplace_back(i);
+	}
+	size_t unflagged = picks.size();
+	for (uint32_t i = 0; i < g.tiles.size(); i++) {
+		if (is_hidden(g.tiles[i]) && is_flagged(g.tiles[i]))
+			picks.emplace_back(i);
+	}
+	if (picks.empty())
+		return {};
+	bool flag = solver_random(g.rng, 8) == 0 || !unflagged;
+	return { picks[solver_random(g.rng, flag ? picks.size() : unflagged)], flag ? batch_action::flag : batch_action::reveal };
+}
+
+// the rules minesweeper_batch_step applies, played with minesweeper_swap_to_empty_tile and minesweeper_reveal
+static void check_step(check_game_t& g, const simulate_difficulty_t& d, const minesweeper_batch_action_t& a, std::vector<uint32_t>& idxs) {
+	if (g.lost || g.won || a.kind == batch_action::none || a.tile >= g.tiles.size())
+		return;
+	if (a.kind == batch_action::flag) {
+		if (is_hidden(g.tiles[a.tile]))
+			g.tiles[a.tile].flags ^= (uint16_t)mine_flag::flagged;
+	}
+	else if (!is_flagged(g.tiles[a.tile])) {
+		if (!g.started) {
+			g.started = true;
+			minesweeper_swap_to_empty_tile(g.tiles, idxs, a.tile, g.seed);
+			minesweeper_neighbors_2d(g.tiles, d.x_tiles, d.y_tiles);
+		}
+		bool hidden = is_hidden(g.tiles[a.tile]);
+		if (hidden && is_mine(g.tiles[a.tile])) {
+			g.lost = true;
+			g.tiles[a.tile].flags &= ~(uint16_t)mine_flag::hidden;
+		}
+		else if (hidden)
+			minesweeper_reveal(g.tiles, idxs, d.x_tiles, d.y_tiles, a.tile);
+	}
+	size_t hidden_safe = 0;
+	for (const mine& m : g.tiles)
+		hidden_safe += is_hidden(m) && !is_mine(m);
+	g.won = !g.lost && !hidden_safe;
+}
+
+// mismatches in one game, the first few are printed
+static uint64_t check_compare(const minesweeper_batch_t& b, const check_game_t& g, uint32_t game, uint64_t step, uint64_t& reported) {
+	uint64_t mismatches = 0;
+	auto report = [&](const char* plane, uint32_t tile, uint32_t batch, uint32_t scalar) {
+		mismatches++;
+		if (reported++ < 10)
+			std::fprintf(stderr, "game %u board %u step %llu tile %u %s: batch %u scalar %u\n", game, g.boards, (unsigned long long)step, tile, plane, batch, scalar);
+	};
+	for (uint32_t tile = 0; tile < g.tiles.size(); tile++) {
+		const mine& m = g.tiles[tile];
+		if (minesweeper_batch_bit(b.hidden, b, tile, game) != is_hidden(m))
+			report("hidden", tile, minesweeper_batch_bit(b.hidden, b, tile, game), is_hidden(m));
+		if (minesweeper_batch_bit(b.flagged, b, tile, game) != is_flagged(m))
+			report("flagged", tile, minesweeper_batch_bit(b.flagged, b, tile, game), is_flagged(m));
+		if (minesweeper_batch_bit(b.mines, b, tile, game) != is_mine(m))
+			report("mine", tile, minesweeper_batch_bit(b.mines, b, tile, game), is_mine(m));
+		if (minesweeper_batch_nearby(b, tile, game) != m.nearby)
+			report("nearby", tile, minesweeper_batch_nearby(b, tile, game), m.nearby);
+	}
+	uint32_t word = game / 64;
+	uint32_t lost = (b.lost[word] >> (game % 64)) & 1;
+	uint32_t won = (b.won[word] >> (game % 64)) & 1;
+	if (lost != g.lost)
+		report("lost", ~uint32_t{ 0 }, lost, g.lost);
+	if (won != g.won)
+		report("won", ~uint32_t{ 0 }, won, g.won);
+	return mismatches;
+}
+
+static void check_usage() {
+	std::fprintf(stderr,
+		"usage: minesweeper_batch_check [options]\n"
+		"  --games N         games stepped together, not a multiple of 64 so the last word is partial (100)\n"
+		"  --boards N        boards dealt to each game, finished games are redealt like the env does (3)\n"
+		"  --difficulty D    easy, intermediate, expert, all or WxHxM (all), may repeat\n"
+		"  --seed N          base seed (0)\n");
+}
+
+int main(int argc, char** argv) {
+	uint32_t games = 100;
+	uint32_t boards = 3;
+	uint64_t seed = 0;
+	std::vector<simulate_difficulty_t> difficulties;
+
+	for (int i = 1; i < argc; i++) {
+		const char* arg = argv[i];
+		const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+		bool ok = value != nullptr;
+		if (!std::strcmp(arg, "--games") && ok) {
+			games = std::strtoul(value, nullptr, 10);
+			ok = games != 0;
+		}
+		else if (!std::strcmp(arg, "--boards") && ok) {
+			boards = std::strtoul(value, nullptr, 10);
+			ok = boards != 0;
+		}
+		else if (!std::strcmp(arg, "--seed") && ok)
+			seed = std::strtoull(value, nullptr, 10);
+		else if (!std::strcmp(arg, "--difficulty") && ok)
+			ok = simulate_parse_difficulty(value, difficulties);
+		else
+			ok = false;
+
+		if (!ok) {
+			check_usage();
+			return 1;
+		}
+		i++;
+	}
+	if (difficulties.empty())
+		difficulties.assign(simulate_difficulties.begin(), simulate_difficulties.end());
+
+	uint64_t total = 0;
+	std::printf("%-22s %8s %8s %10s %10s\n", "difficulty", "games", "boards", "steps", "mismatch");
+	for (const simulate_difficulty_t& d : difficulties) {
+		minesweeper_batch_t b;
+		if (!minesweeper_batch_init(b, games, d.x_tiles, d.y_tiles, d.mine_count)) {
+			std::fprintf(stderr, "%s: no safe tile on a %ux%u board with %llu mines\n", d.name, d.x_tiles, d.y_tiles, (unsigned long long)d.mine_count);
+			return 1;
+		}
+		// board n of a game is seed + game + n * games, the same stride the env uses for auto reset
+		std::vector<uint64_t> seeds(games);
+		std::vector<check_game_t> scalar(games);
+		for (uint32_t game = 0; game < games; game++) {
+			seeds[game] = seed + game;
+			scalar[game].rng = chacha8r(seed, game);
+			check_deal(scalar[game], d, seeds[game]);
+		}
+		minesweeper_batch_reset_all(b, seeds.data());
+
+		std::vector<minesweeper_batch_action_t> actions(games);
+		std::vector<uint32_t> picks;
+		std::vector<uint32_t> idxs;
+		uint64_t mismatches = 0;
+		uint64_t reported = 0;
+		uint64_t dealt = games;
+		uint64_t step = 0;
+		for (bool playing = true; playing; step++) {
+			playing = false;
+			for (uint32_t game = 0; game < games; game++) {
+				check_game_t& g = scalar[game];
+				if ((g.won || g.lost) && g.boards < boards) {
+					seeds[game] += games;
+					check_deal(g, d, seeds[game]);
+					minesweeper_batch_reset(b, game, seeds[game]);
+					dealt++;
+				}
+				actions[game] = g.won || g.lost ? minesweeper_batch_action_t{} : check_pick(g, picks);
+				playing |= actions[game].kind != batch_action::none;
+			}
+			if (!playing)
+				break;
+			minesweeper_batch_step(b, actions.data());
+			for (uint32_t game = 0; game < games; game++) {
+				check_step(scalar[game], d, actions[game], idxs);
+				mismatches += check_compare(b, scalar[game], game, step, reported);
+			}
+		}
+
+		char name[64];
+		std::snprintf(name, sizeof(name), "%s %ux%u/%llu", d.name, d.x_tiles, d.y_tiles, (unsigned long long)d.mine_count);
+		std::printf("%-22s %8u %8llu %10llu %10llu\n", name, games, (unsigned long long)dealt, (unsigned long long)step, (unsigned long long)mismatches);
+		std::fflush(stdout);
+		total += mismatches;
+	}
+	return total ? 1 : 0;
+}
@@ -0,0 +1,223 @@
+﻿// minesweeper_benchmark.cpp : engine and solver throughput per board size, printed as a table and written
+// as csv so runs from different releases can be compared.
+//
+
+#include "minesweeper_simulate.h"
+#include "minesweeper_region.h"
+#include <cstdio>
+
+struct benchmark_row_t {
+	simulate_difficulty_t difficulty;
+	double boards = 0.0; // generated per second
+	double neighbor_tiles = 0.0; // tiles per second through minesweeper_neighbors_2d
+	double reveal_tiles = 0.0; // tiles per second through minesweeper_reveal
+	double clicks_required = 0.0; // 3bv computations per second
+	double solve_tiles = 0.0; // tiles per second through minesweeper_solve, every opening revealed
+	double region_solve_tiles = 0.0; // same position through minesweeper_solve_regions
+	uint64_t region_mismatches = 0; // tiles the two solvers decided differently, anything but 0 is a bug
+	double solver_moves = 0.0; // clicks per second playing with the solver policy
+	uint64_t solver_games = 0; // finished games
+	double solver_win_rate = 0.0; // only meaningful when solver_games isn't 0
+	minesweeper_transposition_stats_t table; // the solver games' transposition table
+};
+
+// calls fn until at least seconds have passed, fn returns how many units it processed
+template<typename Fn>
+double benchmark_rate(double seconds, Fn&& fn) {
+	uint64_t units = 0;
+	auto start = std::chrono::steady_clock::now();
+	double elapsed = 0.0;
+	do {
+		units += fn();
+		elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	} while (elapsed < seconds);
+	return units / elapsed;
+}
+
+inline benchmark_row_t benchmark_difficulty(const simulate_difficulty_t& difficulty, double seconds, uint64_t seed, uint32_t depth, thread_pool_t& region_pool) {
+	benchmark_row_t row;
+	row.difficulty = difficulty;
+	uint32_t x_tiles = difficulty.x_tiles;
+	uint32_t y_tiles = difficulty.y_tiles;
+	uint64_t tile_count = uint64_t{ x_tiles } * y_tiles;
+
+	std::vector<mine> tiles;
+	std::vector<mine> copy;
+	std::vector<uint32_t> idxs;
+	minesweeper_seed_t board_seed = minesweeper_seed(seed);
+
+	row.boards = benchmark_rate(seconds, [&] {
+		minesweeper_start(tiles, x_tiles, y_tiles, difficulty.mine_count, board_seed);
+		return 1;
+	});
+
+	row.neighbor_tiles = benchmark_rate(seconds, [&] {
+		minesweeper_neighbors_2d(tiles, x_tiles, y_tiles);
+		return tile_count;
+	});
+
+	// click every safe tile in order, the first clicks flood open regions and the rest reveal single numbers
+	row.reveal_tiles = benchmark_rate(seconds, [&] {
+		copy.assign(tiles.begin(), tiles.end());
+		for (size_t i = 0; i < copy.size(); i++) {
+			if (!is_mine(copy[i]) && is_hidden(copy[i]))
+				minesweeper_reveal(copy, idxs, x_tiles, y_tiles, i);
+		}
+		uint64_t revealed = 0;
+		for (size_t i = 0; i < copy.size(); i++)
+			revealed += !is_hidden(copy[i]);
+		return revealed;
+	});
+
+	row.clicks_required = benchmark_rate(seconds, [&] {
+		minesweeper_minimum_clicks(copy, tiles, idxs, x_tiles, y_tiles);
+		return 1;
+	});
+
+	// every opening revealed, the position with the most numbers for the solver to work through
+	copy.assign(tiles.begin(), tiles.end());
+	for (size_t i = 0; i < copy.size(); i++) {
+		if (!is_mine(copy[i]) && is_hidden(copy[i]) && !is_near_mine(copy[i]))
+			minesweeper_reveal(copy, idxs, x_tiles, y_tiles, i);
+	}
+	std::vector<mine> visible(copy.size());
+	for (size_t i = 0; i < copy.size(); i++) {
+		visible[i].flags = copy[i].flags & ~(uint16_t)mine_flag::mine;
+		visible[i].nearby = is_hidden(copy[i]) ? 0 : copy[i].nearby;
+	}
+	minesweeper_solver_t serial;
+	minesweeper_solver_t regional;
+	minesweeper_regions_t regions;
+	row.solve_tiles = benchmark_rate(seconds, [&] {
+		minesweeper_solve(serial, visible, x_tiles, y_tiles, difficulty.mine_count);
+		return tile_count;
+	});
+	row.region_solve_tiles = benchmark_rate(seconds, [&] {
+		minesweeper_solve_regions(region_pool, regions, regional, visible, x_tiles, y_tiles, difficulty.mine_count);
+		return tile_count;
+	});
+	for (size_t i = 0; i < visible.size(); i++)
+		row.region_mismatches += serial.marks[i] != regional.marks[i];
+
+	// single threaded so moves per second compare across machines, huge boards may not finish a game
+	thread_pool_t pool(1);
+	simulate_options_t options;
+	options.seed = seed;
+	options.guess.parallel = false;
+	options.guess.depth = depth;
+	options.guess.budget = std::chrono::hours(1);
+	// 3bv has its own row above, per game it would be timed as moves and takes longer than the deadline on huge
+	options.clicks_required = false;
+	// one game after another on one worker, so sharing a table keeps the games reproducible
+	minesweeper_transposition_t table(18);
+	options.table = &table;
+	options.deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds));
+	uint64_t wins = 0;
+	uint64_t game = 0;
+	row.solver_moves = benchmark_rate(seconds, [&] {
+		simulate_result_t r = simulate_game(difficulty, simulate_policy_solver, options, pool, game++);
+		row.solver_games += r.finished;
+		wins += r.won;
+		return r.clicks;
+	});
+	row.solver_win_rate = row.solver_games ? double(wins) / row.solver_games : 0.0;
+	row.table = minesweeper_transposition_stats(table);
+	return row;
+}
+
+static void benchmark_usage() {
+	std::fprintf(stderr,
+		"usage: minesweeper_benchmark [options]\n"
+		"  --difficulty D    easy, intermediate, expert, huge, all or WxHxM (all), may repeat\n"
+		"  --seconds S       minimum time per measurement (0.5)\n"
+		"  --seed N          base seed (0)\n"
+		"  --depth N         solver look ahead depth, the transposition table is only used past 1 (1)\n"
+		"  --threads N       workers for the region solver (hardware threads)\n"
+		"  --out FILE        csv output (minesweeper_benchmark.csv)\n");
+}
+
+int main(int argc, char** argv) {
+	double seconds = 0.5;
+	uint64_t seed = 0;
+	uint32_t depth = 1;
+	size_t threads = std::thread::hardware_concurrency();
+	const char* out = "minesweeper_benchmark.csv";
+	std::vector<simulate_difficulty_t> difficulties;
+	// large enough that per click costs that scale with the board show up
+	simulate_difficulty_t huge = { "huge", 256, 256, 13107 };
+
+	for (int i = 1; i < argc; i++) {
+		const char* arg = argv[i];
+		const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+		bool ok = value != nullptr;
+		if (!std::strcmp(arg, "--seconds") && ok)
+			seconds = std::strtod(value, nullptr);
+		else if (!std::strcmp(arg, "--seed") && ok)
+			seed = std::strtoull(value, nullptr, 10);
+		else if (!std::strcmp(arg, "--depth") && ok)
+			depth = std::strtoul(value, nullptr, 10);
+		else if (!std::strcmp(arg, "--threads") && ok)
+			threads = std::strtoull(value, nullptr, 10);
+		else if (!std::strcmp(arg, "--out") && ok)
+			out = value;
+		else if (!std::strcmp(arg, "--difficulty") && ok && !std::strcmp(value, "huge"))
+			difficulties.emplace_back(huge);
+		else if (!std::strcmp(arg, "--difficulty") && ok) {
+			bool all = !std::strcmp(value, "all");
+			ok = simulate_parse_difficulty(value, difficulties);
+			if (all)
+				difficulties.emplace_back(huge);
+		}
+		else
+			ok = false;
+
+		if (!ok) {
+			benchmark_usage();
+			return 1;
+		}
+		i++;
+	}
+	if (difficulties.empty()) {
+		difficulties.assign(simulate_difficulties.begin(), simulate_difficulties.end());
+		difficulties.emplace_back(huge);
+	}
+
+	// the calling thread takes part in parallel_for, so threads - 1 workers
+	thread_pool_t region_pool(std::max<size_t>(threads, 2) - 1);
+	std::vector<benchmark_row_t> rows;
+	std::printf("%-24s %12s %14s %14s %10s %12s %12s %9s %12s %8s %9s %12s %9s\n", "difficulty", "boards/s", "neighbors/s", "reveal/s", "3bv/s", "solve/s", "regions/s", "mismatch",
+		"moves/s", "games", "win rate", "tt probes", "hit rate");
+	for (const simulate_difficulty_t& difficulty : difficulties) {
+		benchmark_row_t row = benchmark_difficulty(difficulty, seconds, seed, depth, region_pool);
+		char name[64];
+		std::snprintf(name, sizeof(name), "%s %ux%u/%llu", difficulty.name, difficulty.x_tiles, difficulty.y_tiles, (unsigned long long)difficulty.mine_count);
+		// no finished game has no win rate, 0% would read as losing every game
+		char win_rate[16] = "n/a";
+		if (row.solver_games)
+			std::snprintf(win_rate, sizeof(win_rate), "%.2f%%", 100.0 * row.solver_win_rate);
+		std::printf("%-24s %12.0f %14.0f %14.0f %10.1f %12.0f %12.0f %9llu %12.0f %8llu %9s %12llu %8.2f%%\n", name, row.boards, row.neighbor_tiles, row.reveal_tiles,
+			row.clicks_required, row.solve_tiles, row.region_solve_tiles, (unsigned long long)row.region_mismatches, row.solver_moves, (unsigned long long)row.solver_games, win_rate,
+			(unsigned long long)row.table.probes, 100.0 * row.table.hit_rate);
+		std::fflush(stdout);
+		rows.emplace_back(row);
+	}
+
+	FILE* file = std::fopen(out, "w");
+	if (!file) {
+		std::fprintf(stderr, "could not write %s\n", out);
+		return 1;
+	}
+	std::fprintf(file, "difficulty,x_tiles,y_tiles,mines,boards_per_sec,neighbor_tiles_per_sec,reveal_tiles_per_sec,clicks_required_per_sec,solve_tiles_per_sec,region_solve_tiles_per_sec,region_mismatches,solver_moves_per_sec,solver_games,solver_win_rate,table_probes,table_hits,table_stores,table_hit_rate\n");
+	for (const benchmark_row_t& row : rows) {
+		const simulate_difficulty_t& d = row.difficulty;
+		// empty win rate when no game finished
+		char win_rate[16] = "";
+		if (row.solver_games)
+			std::snprintf(win_rate, sizeof(win_rate), "%.4f", row.solver_win_rate);
+		std::fprintf(file, "%s,%u,%u,%llu,%.1f,%.1f,%.1f,%.3f,%.1f,%.1f,%llu,%.1f,%llu,%s,%llu,%llu,%llu,%.4f\n", d.name, d.x_tiles, d.y_tiles, (unsigned long long)d.mine_count,
+			row.boards, row.neighbor_tiles, row.reveal_tiles, row.clicks_required, row.solve_tiles, row.region_solve_tiles, (unsigned long long)row.region_mismatches, row.solver_moves, (unsigned long long)row.solver_games, win_rate,
+			(unsigned long long)row.table.probes, (unsigned long long)row.table.hits, (unsigned long long)row.table.stores, row.table.hit_rate);
+	}
+	std::fclose(file);
+	return 0;
+}
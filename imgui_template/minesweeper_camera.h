@@ -0,0 +1,104 @@
+﻿// minesweeper_camera.h : pan and zoom over the board, and the tiles a clip rect can see so nothing outside the
+// window is ever walked or drawn.
+
+#pragma once
+
+#include "imgui/imgui.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+struct minesweeper_camera_t {
+	ImVec2 origin = {}; // screen position of the board's top left corner
+	float tile_dim = 0.0f;
+	bool fit = true; // follows the window size until the player pans or zooms
+};
+
+// tiles [x0, x1) x [y0, y1)
+struct minesweeper_tile_range_t {
+	uint32_t x0 = 0;
+	uint32_t y0 = 0;
+	uint32_t x1 = 0;
+	uint32_t y1 = 0;
+};
+
+constexpr bool operator==(const minesweeper_tile_range_t& a, const minesweeper_tile_range_t& b) noexcept {
+	return a.x0 == b.x0 && a.y0 == b.y0 && a.x1 == b.x1 && a.y1 == b.y1;
+}
+
+constexpr float minesweeper_camera_max_tile = 128.0f;
+
+// the zoom that shows the whole board, also as far out as the camera goes
+inline float minesweeper_camera_fit_tile(uint32_t x_tiles, uint32_t y_tiles, ImVec2 view_size) {
+	float tile_dim = std::min(view_size.x / std::max<uint32_t>(x_tiles, 1), view_size.y / std::max<uint32_t>(y_tiles, 1));
+	// whole pixels as long as tiles are at least one wide, same as before the camera
+	return tile_dim >= 1.0f ? std::floor(tile_dim) : tile_dim;
+}
+
+// min_tile keeps huge boards from fitting, they start at the top left instead
+inline void minesweeper_camera_fit(minesweeper_camera_t& camera, uint32_t x_tiles, uint32_t y_tiles, ImVec2 view_min, ImVec2 view_size, float min_tile = 0.0f) {
+	camera.origin = view_min;
+	camera.tile_dim = std::max(minesweeper_camera_fit_tile(x_tiles, y_tiles, view_size), min_tile);
+	camera.fit = true;
+}
+
+inline void minesweeper_camera_pan(minesweeper_camera_t& camera, ImVec2 delta) {
+	camera.origin.x += delta.x;
+	camera.origin.y += delta.y;
+	camera.fit = false;
+}
+
+// the board point under anchor stays under it
+inline void minesweeper_camera_zoom(minesweeper_camera_t& camera, ImVec2 anchor, float factor, float min_tile) {
+	float tile_dim = std::clamp(camera.tile_dim * factor, std::min(min_tile, minesweeper_camera_max_tile), minesweeper_camera_max_tile);
+	if (tile_dim == camera.tile_dim || camera.tile_dim <= 0.0f)
+		return;
+	float scale = tile_dim / camera.tile_dim;
+	camera.origin.x = anchor.x - (anchor.x - camera.origin.x) * scale;
+	camera.origin.y = anchor.y - (anchor.y - camera.origin.y) * scale;
+	camera.tile_dim = tile_dim;
+	camera.fit = false;
+}
+
+// a board smaller than the view stays inside it, a bigger one can't leave a gap on either side
+inline void minesweeper_camera_clamp(minesweeper_camera_t& camera, uint32_t x_tiles, uint32_t y_tiles, ImVec2 view_min, ImVec2 view_size) {
+	float board_x = x_tiles * camera.tile_dim;
+	float board_y = y_tiles * camera.tile_dim;
+	float slack_x = view_size.x - board_x;
+	float slack_y = view_size.y - board_y;
+	camera.origin.x = std::clamp(camera.origin.x, view_min.x + std::min(slack_x, 0.0f), view_min.x + std::max(slack_x, 0.0f));
+	camera.origin.y = std::clamp(camera.origin.y, view_min.y + std::min(slack_y, 0.0f), view_min.y + std::max(slack_y, 0.0f));
+}
+
+inline ImVec2 minesweeper_camera_board_max(const minesweeper_camera_t& camera, uint32_t x_tiles, uint32_t y_tiles) {
+	return ImVec2{ camera.origin.x + x_tiles * camera.tile_dim, camera.origin.y + y_tiles * camera.tile_dim };
+}
+
+// the tile under a screen position, ~0 off the board
+inline uint32_t minesweeper_camera_tile(const minesweeper_camera_t& camera, ImVec2 pos, uint32_t x_tiles, uint32_t y_tiles) {
+	if (camera.tile_dim <= 0.0f)
+		return ~uint32_t{ 0 };
+	float x = std::floor((pos.x - camera.origin.x) / camera.tile_dim);
+	float y = std::floor((pos.y - camera.origin.y) / camera.tile_dim);
+	if (x < 0.0f || y < 0.0f || x >= (float)x_tiles || y >= (float)y_tiles)
+		return ~uint32_t{ 0 };
+	return std::min((uint32_t)y, y_tiles - 1) * x_tiles + std::min((uint32_t)x, x_tiles - 1);
+}
+
+// rows and columns that intersect the clip rect, grown by a tile so the grid lines on the edges are kept
+inline minesweeper_tile_range_t minesweeper_camera_visible(const minesweeper_camera_t& camera, ImVec4 clip_rect, uint32_t x_tiles, uint32_t y_tiles) {
+	minesweeper_tile_range_t range;
+	if (camera.tile_dim <= 0.0f)
+		return range;
+	auto first = [&](float min, float origin, uint32_t tiles) {
+		return (uint32_t)std::clamp(std::floor((min - origin) / camera.tile_dim) - 1.0f, 0.0f, (float)tiles);
+	};
+	auto last = [&](float max, float origin, uint32_t tiles) {
+		return (uint32_t)std::clamp(std::ceil((max - origin) / camera.tile_dim) + 1.0f, 0.0f, (float)tiles);
+	};
+	range.x0 = first(clip_rect.x, camera.origin.x, x_tiles);
+	range.y0 = first(clip_rect.y, camera.origin.y, y_tiles);
+	range.x1 = std::max(range.x0, last(clip_rect.z, camera.origin.x, x_tiles));
+	range.y1 = std::max(range.y0, last(clip_rect.w, camera.origin.y, y_tiles));
+	return range;
+}
@@ -0,0 +1,128 @@
+﻿// minesweeper_difficulty.cpp : profiles a batch of boards on every core and writes the profiles as a binary
+// table (minesweeper_difficulty_header_t then the records, zpp_bits encoded).
+//
+
+#include "minesweeper_difficulty.h"
+#include "minesweeper_pool.h"
+#include "zpp_bits.h"
+#include <cstdio>
+
+static void difficulty_usage() {
+	std::fprintf(stderr,
+		"usage: minesweeper_difficulty [options]\n"
+		"  --boards N        boards to profile (10000)\n"
+		"  --difficulty D    easy, intermediate, expert or WxHxM (expert)\n"
+		"  --threads N       pool threads (hardware concurrency)\n"
+		"  --seed N          base seed (0)\n"
+		"  --replays N       plays of each board, guessing differently between ties, for its win rate (8)\n"
+		"  --out FILE        binary table (minesweeper_difficulty.bin)\n"
+		"  --unique          drop boards that repeat an earlier one up to rotation / reflection\n");
+}
+
+int main(int argc, char** argv) {
+	uint64_t boards = 10000;
+	const char* out = "minesweeper_difficulty.bin";
+	simulate_options_t options;
+	options.guess.parallel = false;
+	options.guess.depth = 1;
+	options.guess.budget = std::chrono::hours(1);
+	options.guess.random_ties = true;
+	uint32_t replays = 8;
+	std::vector<simulate_difficulty_t> difficulties;
+	bool unique = false;
+
+	for (int i = 1; i < argc; i++) {
+		const char* arg = argv[i];
+		if (!std::strcmp(arg, "--unique")) {
+			unique = true;
+			continue;
+		}
+		const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+		bool ok = value != nullptr;
+		if (!std::strcmp(arg, "--boards") && ok)
+			boards = std::strtoull(value, nullptr, 10);
+		else if (!std::strcmp(arg, "--threads") && ok)
+			options.threads = std::strtoull(value, nullptr, 10);
+		else if (!std::strcmp(arg, "--seed") && ok)
+			options.seed = std::strtoull(value, nullptr, 10);
+		else if (!std::strcmp(arg, "--replays") && ok) {
+			replays = std::strtoul(value, nullptr, 10);
+			ok = replays != 0;
+		}
+		else if (!std::strcmp(arg, "--out") && ok)
+			out = value;
+		else if (!std::strcmp(arg, "--difficulty") && ok)
+			ok = std::strcmp(value, "all") && simulate_parse_difficulty(value, difficulties);
+		else
+			ok = false;
+
+		if (!ok) {
+			difficulty_usage();
+			return 1;
+		}
+		i++;
+	}
+	simulate_difficulty_t difficulty = difficulties.size() ? difficulties.back() : simulate_difficulties[2];
+
+	thread_pool_t pool(std::max<size_t>(options.threads, 2) - 1);
+	std::vector<minesweeper_difficulty_t> records(boards);
+	std::vector<minesweeper_difficulty_scratch_t> scratch(pool.size() + 1);
+	std::vector<minesweeper_canonical_scratch_t> canonical(pool.size() + 1);
+	std::vector<uint8_t> keep(boards, 1);
+	minesweeper_board_set_t seen(unique ? boards : 0);
+	// boards take microseconds, hand them out in chunks so scheduling stays off the profile
+	size_t grain = std::max<size_t>(1, boards / ((pool.size() + 1) * 64));
+	auto start = std::chrono::steady_clock::now();
+	parallel_for(pool, 0, boards, grain, [&](size_t board, size_t worker) {
+		records[board] = minesweeper_difficulty(difficulty, options, pool, board, replays, scratch[worker]);
+		if (unique) {
+			// which of two twins survives depends on scheduling, either one profiles the same
+			const std::vector<mine>& played = scratch[worker].board;
+			keep[board] = minesweeper_board_set_insert(seen, minesweeper_canonical_key(canonical[worker], played, difficulty.x_tiles, difficulty.y_tiles));
+		}
+	});
+	size_t kept = 0;
+	for (size_t i = 0; i < records.size(); i++) {
+		if (keep[i])
+			records[kept++] = records[i];
+	}
+	records.resize(kept);
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	minesweeper_difficulty_header_t header;
+	header.x_tiles = difficulty.x_tiles;
+	header.y_tiles = difficulty.y_tiles;
+	header.mine_count = difficulty.mine_count;
+	header.seed = options.seed;
+	header.replays = replays;
+	auto [data, writer] = zpp::bits::data_out();
+	if (zpp::bits::failure(writer(header, records))) {
+		std::fprintf(stderr, "could not encode the table\n");
+		return 1;
+	}
+	FILE* file = std::fopen(out, "wb");
+	if (!file || std::fwrite(data.data(), 1, data.size(), file) != data.size()) {
+		std::fprintf(stderr, "could not write %s\n", out);
+		if (file)
+			std::fclose(file);
+		return 1;
+	}
+	std::fclose(file);
+
+	double n = records.size() ? double(records.size()) : 1.0;
+	double clicks_required = 0.0, openings = 0.0, islands = 0.0, guesses = 0.0, frontier = 0.0, win_rate = 0.0, won = 0.0;
+	for (const minesweeper_difficulty_t& d : records) {
+		clicks_required += d.clicks_required;
+		openings += d.openings;
+		islands += d.islands;
+		guesses += d.guesses;
+		frontier += d.max_frontier;
+		win_rate += d.win_rate;
+		won += d.won;
+	}
+	std::printf("%llu boards (%zu unique) %ux%u/%llu in %.2fs (%.0f boards/s, %zu threads), %zu bytes to %s\n", (unsigned long long)boards, records.size(),
+		difficulty.x_tiles, difficulty.y_tiles, (unsigned long long)difficulty.mine_count, seconds, boards / seconds, pool.size() + 1, data.size(), out);
+	std::printf("mean 3bv %.2f, openings %.2f, islands %.2f, guesses %.3f, max frontier %.1f, win rate %.3f over %u replays (%.3f first play)\n",
+		clicks_required / n, openings / n, islands / n, guesses / n, frontier / n, win_rate / n, replays, won / n);
+	return 0;
+}
@@ -0,0 +1,116 @@
+﻿// minesweeper_difficulty.h : difficulty profile of a board, its static structure (openings, islands, 3bv)
+// plus how the solver fares on it. used to bucket pools of generated boards.
+
+#pragma once
+
+#include "minesweeper_simulate.h"
+
+struct minesweeper_difficulty_t {
+	uint64_t seed = 0; // board index passed to simulate_game, regenerates the board
+	uint32_t clicks_required = 0; // 3bv
+	uint32_t openings = 0; // connected regions of zeros
+	uint32_t opening_tiles = 0; // tiles revealed by all openings together
+	uint32_t largest_opening = 0;
+	uint32_t islands = 0; // connected groups of numbers no opening reveals
+	uint32_t guesses = 0; // solver clicks it couldn't prove safe
+	uint32_t max_frontier = 0; // most undecided tiles next to numbers at once
+	float win_rate = 0.0f; // share of the replays the solver won
+	uint8_t won = 0; // the first replay, the one the rest of the profile comes from
+};
+
+struct minesweeper_difficulty_header_t {
+	uint32_t magic = 0x4644534d; // "MSDF"
+	uint32_t version = 2;
+	uint32_t x_tiles = 0;
+	uint32_t y_tiles = 0;
+	uint64_t mine_count = 0;
+	uint64_t seed = 0;
+	uint32_t replays = 0; // plays behind each win rate
+};
+
+struct minesweeper_difficulty_scratch_t {
+	std::vector<mine> board;
+	std::vector<uint32_t> stamp; // last opening / island that touched each tile, + 1
+	std::vector<uint8_t> covered; // revealed by some opening
+	std::vector<uint32_t> queue;
+};
+
+// 8 connected flood over tiles accepted by grow, every tile visited gets stamped with id. returns tiles visited,
+// counting the ones accept lets in but grow doesn't spread from (numbers around an opening).
+template<typename Accept, typename Grow>
+uint32_t minesweeper_difficulty_flood(minesweeper_difficulty_scratch_t& s, uint32_t x_tiles, uint32_t y_tiles, uint32_t start, uint32_t id, Accept&& accept, Grow&& grow) {
+	uint32_t visited = 1;
+	s.queue.clear();
+	s.queue.emplace_back(start);
+	s.stamp[start] = id;
+	for (size_t i = 0; i < s.queue.size(); i++) {
+		uint32_t tile = s.queue[i];
+		if (!grow(tile))
+			continue;
+		int x = tile % x_tiles;
+		int y = tile / x_tiles;
+		for (size_t o = 0; o < solver_offsets.size(); o++) {
+			int nx = x + solver_offsets[o].x;
+			int ny = y + solver_offsets[o].y;
+			if (nx < 0 || ny < 0 || nx >= (int)x_tiles || ny >= (int)y_tiles)
+				continue;
+			uint32_t n = ny * x_tiles + nx;
+			if (s.stamp[n] == id || !accept(n))
+				continue;
+			s.stamp[n] = id;
+			s.queue.emplace_back(n);
+			visited++;
+		}
+	}
+	return visited;
+}
+
+// openings and islands of a board with its numbers filled in
+inline void minesweeper_difficulty_structure(minesweeper_difficulty_t& d, minesweeper_difficulty_scratch_t& s, const std::vector<mine>& board, uint32_t x_tiles, uint32_t y_tiles) {
+	s.stamp.assign(board.size(), 0);
+	s.covered.assign(board.size(), 0);
+	uint32_t id = 0;
+
+	auto zero = [&](uint32_t tile) { return !is_mine(board[tile]) && !is_near_mine(board[tile]); };
+	for (uint32_t tile = 0; tile < board.size(); tile++) {
+		if (!zero(tile) || s.covered[tile])
+			continue;
+		// numbers on the rim can border two openings, so each opening gets its own stamp
+		uint32_t size = minesweeper_difficulty_flood(s, x_tiles, y_tiles, tile, ++id, [&](uint32_t n) { return !is_mine(board[n]); }, zero);
+		for (uint32_t t : s.queue)
+			s.covered[t] = 1;
+		d.openings++;
+		d.largest_opening = std::max(d.largest_opening, size);
+	}
+	for (uint8_t c : s.covered)
+		d.opening_tiles += c;
+
+	auto island = [&](uint32_t n) { return !is_mine(board[n]) && !s.covered[n]; };
+	uint32_t first_island = id + 1;
+	for (uint32_t tile = 0; tile < board.size(); tile++) {
+		if (!island(tile) || s.stamp[tile] >= first_island)
+			continue;
+		minesweeper_difficulty_flood(s, x_tiles, y_tiles, tile, ++id, island, [](uint32_t) { return true; });
+		d.islands++;
+	}
+}
+
+// plays board index with the solver policy replays times, each with its own guess stream, and profiles the board
+// the first play played. options.guess.random_ties lets the replays guess differently where tiles tie.
+inline minesweeper_difficulty_t minesweeper_difficulty(const simulate_difficulty_t& difficulty, const simulate_options_t& options, thread_pool_t& pool, uint64_t index, uint32_t replays, minesweeper_difficulty_scratch_t& s) {
+	minesweeper_difficulty_t d;
+	d.seed = index;
+	s.board.clear();
+	simulate_result_t r = simulate_game(difficulty, simulate_policy_solver, options, pool, index, &s.board);
+	d.clicks_required = r.clicks_required;
+	d.guesses = r.guesses;
+	d.max_frontier = r.max_frontier;
+	d.won = r.won;
+	uint32_t wins = r.won;
+	for (uint32_t stream = 1; stream < replays; stream++)
+		wins += simulate_game(difficulty, simulate_policy_solver, options, pool, index, nullptr, stream).won;
+	d.win_rate = replays ? float(wins) / float(replays) : float(r.won);
+	if (s.board.size())
+		minesweeper_difficulty_structure(d, s, s.board, difficulty.x_tiles, difficulty.y_tiles);
+	return d;
+}
@@ -0,0 +1,163 @@
+﻿// minesweeper_env.h : vectorized environment for training agents. steps every game of a batch at once and
+// writes observations, rewards and done flags straight into buffers the trainer owns.
+
+#pragma once
+
+#include "minesweeper_batch.h"
+
+enum class env_plane : uint32_t {
+	hidden = 0,
+	flagged = 1,
+	number = 2, // 0 - 8 on revealed tiles, 0 on hidden ones
+	count = 3,
+};
+
+struct minesweeper_env_config_t {
+	float reward_win = 1.0f;
+	float reward_loss = -1.0f;
+	float reward_progress = 1.0f; // split over the safe tiles, a whole board is worth this much
+	float reward_noop = -0.01f; // revealed or flagged tiles clicked again
+	bool auto_reset = true; // finished games are dealt a new board in the same step
+};
+
+// observations are uint8 [game][plane][tile], one tile count per plane
+struct minesweeper_env_t {
+	minesweeper_batch_t batch;
+	minesweeper_env_config_t config;
+	std::vector<uint64_t> seeds; // seed of each game's current board
+	uint64_t seed_stride = 0; // auto reset moves a game to seed + stride
+	std::vector<uint32_t> revealed; // safe tiles revealed per game at the last observation
+	std::vector<uint32_t> counts; // same, for the observation being written
+	std::vector<uint8_t> flagged; // whether the tile each action names was flagged before the step
+	std::vector<uint64_t> column; // one word of every plane, 7 per tile
+	std::vector<minesweeper_batch_action_t> actions;
+};
+
+inline size_t minesweeper_env_observation_size(const minesweeper_env_t& env) {
+	return (size_t)env_plane::count * env.batch.x_tiles * env.batch.y_tiles;
+}
+
+// actions are tile (reveal) or tile + tile count (flag)
+inline uint32_t minesweeper_env_action_count(const minesweeper_env_t& env) {
+	return 2 * env.batch.x_tiles * env.batch.y_tiles;
+}
+
+// false when the board has no safe tile
+inline bool minesweeper_env_init(minesweeper_env_t& env, uint32_t games, uint32_t x_tiles, uint32_t y_tiles, uint64_t mine_count, const minesweeper_env_config_t& config = {}) {
+	if (!minesweeper_batch_init(env.batch, games, x_tiles, y_tiles, mine_count))
+		return false;
+	env.config = config;
+	env.seeds.assign(games, 0);
+	env.seed_stride = games;
+	env.revealed.assign(games, 0);
+	env.counts.assign(games, 0);
+	env.flagged.assign(games, 0);
+	env.column.assign(size_t{ 7 } * x_tiles * y_tiles, 0);
+	env.actions.resize(games);
+	return true;
+}
+
+// planes for the 64 games of one word. the word's column of every plane is gathered first so each game is
+// then written front to back from cache. revealed[game] gets how many safe tiles the game has revealed.
+inline void minesweeper_env_observe(minesweeper_env_t& env, uint32_t word, uint8_t* observations, uint32_t* revealed) {
+	const minesweeper_batch_t& b = env.batch;
+	size_t tile_count = size_t{ b.x_tiles } * b.y_tiles;
+	size_t size = minesweeper_env_observation_size(env);
+	uint64_t* hidden = env.column.data();
+	uint64_t* flagged = hidden + tile_count;
+	uint64_t* open = flagged + tile_count;
+	std::array<uint64_t*, 4> nearby = { open + tile_count, open + 2 * tile_count, open + 3 * tile_count, open + 4 * tile_count };
+	for (size_t tile = 0; tile < tile_count; tile++) {
+		size_t at = tile * b.words + word;
+		hidden[tile] = b.hidden[at];
+		flagged[tile] = b.flagged[at];
+		open[tile] = ~b.hidden[at] & ~b.mines[at];
+		for (size_t i = 0; i < nearby.size(); i++)
+			nearby[i][tile] = b.nearby[i][at];
+	}
+
+	uint32_t first = word * 64;
+	uint32_t lanes = std::min<uint32_t>(64, b.games - first);
+	for (uint32_t lane = 0; lane < lanes; lane++) {
+		uint8_t* observation = observations + (first + lane) * size;
+		uint8_t* hidden_plane = observation + (size_t)env_plane::hidden * tile_count;
+		uint8_t* flagged_plane = observation + (size_t)env_plane::flagged * tile_count;
+		uint8_t* number_plane = observation + (size_t)env_plane::number * tile_count;
+		uint32_t count = 0;
+		for (size_t tile = 0; tile < tile_count; tile++) {
+			uint8_t is_open = (open[tile] >> lane) & 1;
+			uint8_t n = ((nearby[0][tile] >> lane) & 1) | (((nearby[1][tile] >> lane) & 1) << 1)
+				| (((nearby[2][tile] >> lane) & 1) << 2) | (((nearby[3][tile] >> lane) & 1) << 3);
+			hidden_plane[tile] = (hidden[tile] >> lane) & 1;
+			flagged_plane[tile] = (flagged[tile] >> lane) & 1;
+			number_plane[tile] = n & -is_open;
+			count += is_open;
+		}
+		revealed[first + lane] = count;
+	}
+}
+
+// a freshly dealt board is all hidden, no need to look at the planes
+inline void minesweeper_env_observe_new(const minesweeper_env_t& env, uint8_t* observation) {
+	size_t tile_count = size_t{ env.batch.x_tiles } * env.batch.y_tiles;
+	std::memset(observation, 0, minesweeper_env_observation_size(env));
+	std::memset(observation + (size_t)env_plane::hidden * tile_count, 1, tile_count);
+}
+
+// deals board seeds[game] to every game and writes the first observations
+inline void minesweeper_env_reset(minesweeper_env_t& env, const uint64_t* seeds, uint8_t* observations) {
+	std::copy(seeds, seeds + env.batch.games, env.seeds.begin());
+	minesweeper_batch_reset_all(env.batch, seeds);
+	size_t size = minesweeper_env_observation_size(env);
+	for (uint32_t game = 0; game < env.batch.games; game++) {
+		minesweeper_env_observe_new(env, observations + game * size);
+		env.revealed[game] = 0;
+	}
+}
+
+// one action per game. observations are the state after the step, or the new board when a finished game
+// was reset, in which case dones[game] is 1 and rewards[game] is the finishing reward.
+inline void minesweeper_env_step(minesweeper_env_t& env, const uint32_t* actions, uint8_t* observations, float* rewards, uint8_t* dones) {
+	minesweeper_batch_t& b = env.batch;
+	uint32_t tile_count = b.x_tiles * b.y_tiles;
+	uint32_t safe_count = tile_count - b.mine_count;
+	float progress = safe_count ? env.config.reward_progress / safe_count : 0.0f;
+
+	for (uint32_t game = 0; game < b.games; game++) {
+		uint32_t action = actions[game];
+		bool flag = action >= tile_count;
+		minesweeper_batch_action_t& a = env.actions[game];
+		a.tile = flag ? action - tile_count : action;
+		a.kind = flag ? batch_action::flag : batch_action::reveal;
+		env.flagged[game] = a.tile < tile_count && minesweeper_batch_bit(b.flagged, b, a.tile, game);
+	}
+	minesweeper_batch_step(b, env.actions.data());
+
+	size_t size = minesweeper_env_observation_size(env);
+	for (uint32_t word = 0; word < b.words; word++)
+		minesweeper_env_observe(env, word, observations, env.counts.data());
+
+	for (uint32_t game = 0; game < b.games; game++) {
+		const minesweeper_batch_action_t& a = env.actions[game];
+		uint32_t revealed = env.counts[game];
+		bool won = (b.won[game / 64] >> (game % 64)) & 1;
+		bool lost = (b.lost[game / 64] >> (game % 64)) & 1;
+		float reward = (revealed - env.revealed[game]) * progress;
+		if (a.kind == batch_action::reveal && revealed == env.revealed[game] && !lost)
+			reward += env.config.reward_noop;
+		if (a.kind == batch_action::flag && (a.tile >= tile_count || minesweeper_batch_bit(b.flagged, b, a.tile, game) == env.flagged[game]))
+			reward += env.config.reward_noop;
+		reward += won ? env.config.reward_win : 0.0f;
+		reward += lost ? env.config.reward_loss : 0.0f;
+		rewards[game] = reward;
+		dones[game] = won || lost;
+		env.revealed[game] = revealed;
+
+		if ((won || lost) && env.config.auto_reset) {
+			env.seeds[game] += env.seed_stride;
+			minesweeper_batch_reset(b, game, env.seeds[game]);
+			minesweeper_env_observe_new(env, observations + game * size);
+			env.revealed[game] = 0;
+		}
+	}
+}
@@ -0,0 +1,96 @@
+﻿// minesweeper_env_benchmark.cpp : steps a minesweeper_env_t with a uniformly random agent and reports
+// environment steps per second and how often games finish and are dealt a new board.
+//
+
+#include "minesweeper_env.h"
+#include "minesweeper_simulate.h"
+#include <cstdio>
+
+static void env_usage() {
+	std::fprintf(stderr,
+		"usage: minesweeper_env_benchmark [options]\n"
+		"  --games N         games in the batch (256)\n"
+		"  --difficulty D    easy, intermediate, expert, all or WxHxM (all), may repeat\n"
+		"  --seconds S       minimum time stepping per difficulty (1)\n"
+		"  --seed N          base seed, also seeds the agent (0)\n");
+}
+
+int main(int argc, char** argv) {
+	uint32_t games = 256;
+	double seconds = 1.0;
+	uint64_t seed = 0;
+	std::vector<simulate_difficulty_t> difficulties;
+
+	for (int i = 1; i < argc; i++) {
+		const char* arg = argv[i];
+		const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+		bool ok = value != nullptr;
+		if (!std::strcmp(arg, "--games") && ok) {
+			games = std::strtoul(value, nullptr, 10);
+			ok = games != 0;
+		}
+		else if (!std::strcmp(arg, "--seconds") && ok)
+			seconds = std::strtod(value, nullptr);
+		else if (!std::strcmp(arg, "--seed") && ok)
+			seed = std::strtoull(value, nullptr, 10);
+		else if (!std::strcmp(arg, "--difficulty") && ok)
+			ok = simulate_parse_difficulty(value, difficulties);
+		else
+			ok = false;
+
+		if (!ok) {
+			env_usage();
+			return 1;
+		}
+		i++;
+	}
+	if (difficulties.empty())
+		difficulties.assign(simulate_difficulties.begin(), simulate_difficulties.end());
+
+	std::printf("%u games per batch, random agent\n\n", games);
+	std::printf("%-22s %12s %14s %10s %9s\n", "difficulty", "batch/s", "steps/s", "resets", "win rate");
+	for (const simulate_difficulty_t& d : difficulties) {
+		minesweeper_env_t env;
+		if (!minesweeper_env_init(env, games, d.x_tiles, d.y_tiles, d.mine_count)) {
+			std::fprintf(stderr, "%s: no safe tile on a %ux%u board with %llu mines\n", d.name, d.x_tiles, d.y_tiles, (unsigned long long)d.mine_count);
+			return 1;
+		}
+		std::vector<uint8_t> observations(games * minesweeper_env_observation_size(env));
+		std::vector<float> rewards(games);
+		std::vector<uint8_t> dones(games);
+		std::vector<uint32_t> actions(games);
+		std::vector<uint64_t> seeds(games);
+		for (uint32_t game = 0; game < games; game++)
+			seeds[game] = seed + game;
+		minesweeper_env_reset(env, seeds.data(), observations.data());
+
+		// only the steps are timed, drawing the agent's actions is not the env's cost
+		chacha8r rng(seed, 0);
+		uint32_t action_count = minesweeper_env_action_count(env);
+		uint64_t steps = 0;
+		uint64_t resets = 0;
+		uint64_t wins = 0;
+		double elapsed = 0.0;
+		while (elapsed < seconds) {
+			for (uint32_t game = 0; game < games; game++)
+				actions[game] = solver_random(rng, action_count);
+			auto start = std::chrono::steady_clock::now();
+			minesweeper_env_step(env, actions.data(), observations.data(), rewards.data(), dones.data());
+			elapsed += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			steps++;
+			for (uint32_t game = 0; game < games; game++) {
+				resets += dones[game];
+				wins += dones[game] && rewards[game] > 0.0f; // default rewards, only a win ends a game above 0
+			}
+		}
+
+		// resets are per game step, the chance a random action ends its game
+		double game_steps = double(steps) * games;
+		char name[64];
+		std::snprintf(name, sizeof(name), "%s %ux%u/%llu", d.name, d.x_tiles, d.y_tiles, (unsigned long long)d.mine_count);
+		std::printf("%-22s %12.1f %14.0f %9.3f%% %8.2f%%\n", name, steps / elapsed, game_steps / elapsed, 100.0 * resets / game_steps,
+			resets ? 100.0 * wins / resets : 0.0);
+		std::fflush(stdout);
+	}
+	return 0;
+}
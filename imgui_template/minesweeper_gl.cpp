@@ -0,0 +1,276 @@
+﻿// minesweeper_gl.cpp : shader and render callback for minesweeper_gl.h, built on the backend's loader.
+//
+
+#include "minesweeper_gl.h"
+#include "imgui/imgui_impl_opengl3_loader.h"
+#include <cstdio>
+#include <cstring>
+
+// the quad comes from gl_VertexID, no vertex buffer
+static const char* minesweeper_gl_vertex_shader =
+	"uniform mat4 ProjMtx;\n"
+	"uniform vec4 Rect;\n"
+	"out vec2 Frag_Pos;\n"
+	"void main()\n"
+	"{\n"
+	"    vec2 corner = vec2(float(gl_VertexID & 1), float(gl_VertexID >> 1));\n"
+	"    Frag_Pos = mix(Rect.xy, Rect.zw, corner);\n"
+	"    gl_Position = ProjMtx * vec4(Frag_Pos, 0, 1);\n"
+	"}\n";
+
+// Frag_Pos is the pixel center in imgui coordinates. tiles, digits and lines are composited here in the
+// order the mesh draws them, lines get the coverage of imgui's anti aliased lines. digits are placed like
+// AddText places them, which can run a pixel or two past the tile, so the tiles above and to the left are
+// checked too.
+static const char* minesweeper_gl_fragment_shader =
+	"uniform sampler2D Board;\n"
+	"uniform sampler2D Font;\n"
+	"uniform vec2 Origin;\n"
+	"uniform float TileDim;\n"
+	"uniform float LineWidth;\n"
+	"uniform int Hovered;\n"
+	"uniform vec4 Colors[8];\n"
+	"uniform vec4 LineColor;\n"
+	"uniform vec4 Glyphs[8];\n"
+	"uniform vec4 GlyphUVs[8];\n"
+	"in vec2 Frag_Pos;\n"
+	"vec4 over(vec4 acc, vec3 color, float alpha)\n"
+	"{\n"
+	"    return vec4(color * alpha, alpha) + acc * (1.0 - alpha);\n"
+	"}\n"
+	"void main()\n"
+	"{\n"
+	"    ivec2 size = textureSize(Board, 0);\n"
+	"    vec2 board = vec2(size) * TileDim;\n"
+	"    vec2 local = Frag_Pos - Origin;\n"
+	"    vec4 acc = vec4(0.0);\n"
+	"    if (all(greaterThanEqual(local, vec2(0.0))) && all(lessThan(local, board)))\n"
+	"    {\n"
+	"        ivec2 t = min(ivec2(floor(local / TileDim)), size - 1);\n"
+	"        int state = int(texelFetch(Board, t, 0).r * 255.0 + 0.5);\n"
+	"        int kind = (state & 0x40) != 0 ? 3 : (state & 0x30) == 0x30 ? 2 : (state & 0x10) != 0 ? 0 : 1;\n"
+	"        if (t.y * size.x + t.x == Hovered)\n"
+	"            kind += 4;\n"
+	"        acc = vec4(Colors[kind].rgb, 1.0);\n"
+	"        for (int j = 3; j >= 0; j--)\n"
+	"        {\n"
+	"            ivec2 n = t - ivec2(j & 1, j >> 1);\n"
+	"            if (n.x < 0 || n.y < 0)\n"
+	"                continue;\n"
+	"            int digit = int(texelFetch(Board, n, 0).r * 255.0 + 0.5);\n"
+	"            int nearby = digit & 0x0f;\n"
+	"            if ((digit & 0x10) != 0 || nearby == 0)\n"
+	"                continue;\n"
+	"            vec2 center = floor(Origin + (vec2(n) + 0.5) * TileDim);\n"
+	"            vec4 box = Glyphs[nearby - 1] + center.xyxy;\n"
+	"            if (all(greaterThanEqual(Frag_Pos, box.xy)) && all(lessThan(Frag_Pos, box.zw)))\n"
+	"            {\n"
+	"                vec4 uv = GlyphUVs[nearby - 1];\n"
+	"                vec4 glyph = texture(Font, mix(uv.xy, uv.zw, (Frag_Pos - box.xy) / (box.zw - box.xy)));\n"
+	"                acc = over(acc, glyph.rgb, glyph.a);\n"
+	"            }\n"
+	"        }\n"
+	"    }\n"
+	"    vec2 line = local - 0.5;\n"
+	"    vec2 nearest = clamp(floor(line / TileDim + 0.5), vec2(0.0), vec2(size)) * TileDim;\n"
+	"    vec2 coverage = clamp(0.5 * (max(LineWidth, 1.0) + 1.0) - abs(line - nearest), 0.0, 1.0);\n"
+	"    if (line.y >= 0.0 && line.y <= board.y)\n"
+	"        acc = over(acc, LineColor.rgb, coverage.x * LineColor.a);\n"
+	"    if (line.x >= 0.0 && line.x <= board.x)\n"
+	"        acc = over(acc, LineColor.rgb, coverage.y * LineColor.a);\n"
+	"    if (acc.a <= 0.0)\n"
+	"        discard;\n"
+	"    Out_Color = vec4(acc.rgb / acc.a, acc.a);\n"
+	"}\n";
+
+static bool minesweeper_gl_check(GLuint handle, bool program, const char* desc) {
+	GLint status = 0;
+	GLint log_length = 0;
+	if (program) {
+		glGetProgramiv(handle, GL_LINK_STATUS, &status);
+		glGetProgramiv(handle, GL_INFO_LOG_LENGTH, &log_length);
+	}
+	else {
+		glGetShaderiv(handle, GL_COMPILE_STATUS, &status);
+		glGetShaderiv(handle, GL_INFO_LOG_LENGTH, &log_length);
+	}
+	if ((GLboolean)status == GL_FALSE)
+		fprintf(stderr, "minesweeper_gl: failed to %s %s\n", program ? "link" : "compile", desc);
+	if ((GLboolean)status == GL_FALSE && log_length > 1) {
+		std::vector<char> log(log_length + 1);
+		if (program)
+			glGetProgramInfoLog(handle, log_length, nullptr, log.data());
+		else
+			glGetShaderInfoLog(handle, log_length, nullptr, log.data());
+		fprintf(stderr, "%s\n", log.data());
+	}
+	return (GLboolean)status == GL_TRUE;
+}
+
+bool minesweeper_gl_init(minesweeper_gl_t& gl, const char* glsl_version) {
+	gl.ready = false;
+	int version = 130;
+	if (glsl_version)
+		sscanf(glsl_version, "#version %d", &version);
+	bool es = glsl_version && std::strstr(glsl_version, " es");
+	// texelFetch, textureSize and integer bit ops
+	if (version < 130 || (es && version < 300))
+		return false;
+
+	char header[64];
+	std::snprintf(header, sizeof(header), "%s\n", glsl_version ? glsl_version : "#version 130");
+	const char* precision = es ? "precision highp float;\nprecision highp int;\n" : "";
+	const char* output = es ? "layout (location = 0) out vec4 Out_Color;\n" : "out vec4 Out_Color;\n";
+
+	const GLchar* vertex_sources[3] = { header, precision, minesweeper_gl_vertex_shader };
+	GLuint vertex = glCreateShader(GL_VERTEX_SHADER);
+	glShaderSource(vertex, 3, vertex_sources, nullptr);
+	glCompileShader(vertex);
+	bool ok = minesweeper_gl_check(vertex, false, "vertex shader");
+
+	const GLchar* fragment_sources[4] = { header, precision, output, minesweeper_gl_fragment_shader };
+	GLuint fragment = glCreateShader(GL_FRAGMENT_SHADER);
+	glShaderSource(fragment, 4, fragment_sources, nullptr);
+	glCompileShader(fragment);
+	ok = minesweeper_gl_check(fragment, false, "fragment shader") && ok;
+
+	gl.program = glCreateProgram();
+	glAttachShader(gl.program, vertex);
+	glAttachShader(gl.program, fragment);
+	glLinkProgram(gl.program);
+	ok = ok && minesweeper_gl_check(gl.program, true, "program");
+	glDetachShader(gl.program, vertex);
+	glDetachShader(gl.program, fragment);
+	glDeleteShader(vertex);
+	glDeleteShader(fragment);
+	if (!ok) {
+		glDeleteProgram(gl.program);
+		gl.program = 0;
+		return false;
+	}
+
+	gl.uniform_proj_mtx = glGetUniformLocation(gl.program, "ProjMtx");
+	gl.uniform_rect = glGetUniformLocation(gl.program, "Rect");
+	gl.uniform_board = glGetUniformLocation(gl.program, "Board");
+	gl.uniform_font = glGetUniformLocation(gl.program, "Font");
+	gl.uniform_origin = glGetUniformLocation(gl.program, "Origin");
+	gl.uniform_tile_dim = glGetUniformLocation(gl.program, "TileDim");
+	gl.uniform_line_width = glGetUniformLocation(gl.program, "LineWidth");
+	gl.uniform_hovered = glGetUniformLocation(gl.program, "Hovered");
+	gl.uniform_colors = glGetUniformLocation(gl.program, "Colors");
+	gl.uniform_line_color = glGetUniformLocation(gl.program, "LineColor");
+	gl.uniform_glyphs = glGetUniformLocation(gl.program, "Glyphs");
+	gl.uniform_glyph_uvs = glGetUniformLocation(gl.program, "GlyphUVs");
+
+	// core profiles want a vertex array bound even with no attributes
+	glGenVertexArrays(1, &gl.vertex_array);
+	glGenTextures(1, &gl.texture);
+	GLint last_texture = 0;
+	glGetIntegerv(GL_TEXTURE_BINDING_2D, &last_texture);
+	glBindTexture(GL_TEXTURE_2D, gl.texture);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glBindTexture(GL_TEXTURE_2D, last_texture);
+	glGetIntegerv(GL_MAX_TEXTURE_SIZE, &gl.max_texture_size);
+	gl.texture_x = 0;
+	gl.texture_y = 0;
+	gl.valid = false;
+	gl.ready = true;
+	return true;
+}
+
+void minesweeper_gl_shutdown(minesweeper_gl_t& gl) {
+	if (gl.program)
+		glDeleteProgram(gl.program);
+	if (gl.vertex_array)
+		glDeleteVertexArrays(1, &gl.vertex_array);
+	if (gl.texture)
+		glDeleteTextures(1, &gl.texture);
+	gl.program = 0;
+	gl.vertex_array = 0;
+	gl.texture = 0;
+	gl.ready = false;
+}
+
+// only the rows touched since the last frame, the whole board after a resize
+static void minesweeper_gl_upload(minesweeper_gl_t& gl) {
+	GLint last_alignment = 0;
+	glGetIntegerv(GL_UNPACK_ALIGNMENT, &last_alignment);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+	if (gl.texture_x != gl.x_tiles || gl.texture_y != gl.y_tiles) {
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, gl.x_tiles, gl.y_tiles, 0, GL_RED, GL_UNSIGNED_BYTE, gl.state.data());
+		gl.texture_x = gl.x_tiles;
+		gl.texture_y = gl.y_tiles;
+	}
+	else if (gl.first_row <= gl.last_row) {
+		const uint8_t* rows = gl.state.data() + size_t{ gl.first_row } * gl.x_tiles;
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, gl.first_row, gl.x_tiles, gl.last_row - gl.first_row + 1, GL_RED, GL_UNSIGNED_BYTE, rows);
+	}
+	glPixelStorei(GL_UNPACK_ALIGNMENT, last_alignment);
+	gl.first_row = 1;
+	gl.last_row = 0;
+}
+
+void minesweeper_gl_render(const ImDrawList* parent_list, const ImDrawCmd* cmd) {
+	IM_UNUSED(parent_list);
+	minesweeper_gl_t& gl = *(minesweeper_gl_t*)cmd->UserCallbackData;
+	ImDrawData* draw_data = ImGui::GetDrawData();
+	if (!gl.ready || !draw_data || !gl.x_tiles || !gl.y_tiles || gl.state.size() != size_t{ gl.x_tiles } * gl.y_tiles)
+		return;
+
+	// same scissor the backend would give a regular command
+	ImVec2 clip_off = draw_data->DisplayPos;
+	ImVec2 clip_scale = draw_data->FramebufferScale;
+	int fb_height = (int)(draw_data->DisplaySize.y * clip_scale.y);
+	ImVec2 clip_min((cmd->ClipRect.x - clip_off.x) * clip_scale.x, (cmd->ClipRect.y - clip_off.y) * clip_scale.y);
+	ImVec2 clip_max((cmd->ClipRect.z - clip_off.x) * clip_scale.x, (cmd->ClipRect.w - clip_off.y) * clip_scale.y);
+	if (clip_max.x <= clip_min.x || clip_max.y <= clip_min.y)
+		return;
+	glScissor((int)clip_min.x, (int)((float)fb_height - clip_max.y), (int)(clip_max.x - clip_min.x), (int)(clip_max.y - clip_min.y));
+
+	glActiveTexture(GL_TEXTURE0 + 1);
+	glBindTexture(GL_TEXTURE_2D, gl.font_texture);
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, gl.texture);
+	minesweeper_gl_upload(gl);
+
+	float L = draw_data->DisplayPos.x;
+	float R = draw_data->DisplayPos.x + draw_data->DisplaySize.x;
+	float T = draw_data->DisplayPos.y;
+	float B = draw_data->DisplayPos.y + draw_data->DisplaySize.y;
+	const float ortho_projection[4][4] = {
+		{ 2.0f / (R - L), 0.0f, 0.0f, 0.0f },
+		{ 0.0f, 2.0f / (T - B), 0.0f, 0.0f },
+		{ 0.0f, 0.0f, -1.0f, 0.0f },
+		{ (R + L) / (L - R), (T + B) / (B - T), 0.0f, 1.0f },
+	};
+	// the board plus room for the outer lines, cut down to the clip rect so a zoomed in board stays a small quad
+	float margin = 0.5f * (std::max(gl.line_width, 1.0f) + 1.0f) + 1.0f;
+	float rect[4] = {
+		std::max(gl.origin.x - margin, cmd->ClipRect.x),
+		std::max(gl.origin.y - margin, cmd->ClipRect.y),
+		std::min(gl.origin.x + gl.x_tiles * gl.tile_dim + margin, cmd->ClipRect.z),
+		std::min(gl.origin.y + gl.y_tiles * gl.tile_dim + margin, cmd->ClipRect.w),
+	};
+	if (rect[2] <= rect[0] || rect[3] <= rect[1])
+		return;
+
+	glUseProgram(gl.program);
+	glUniformMatrix4fv(gl.uniform_proj_mtx, 1, GL_FALSE, &ortho_projection[0][0]);
+	glUniform4fv(gl.uniform_rect, 1, rect);
+	glUniform1i(gl.uniform_board, 0);
+	glUniform1i(gl.uniform_font, 1);
+	glUniform2f(gl.uniform_origin, gl.origin.x, gl.origin.y);
+	glUniform1f(gl.uniform_tile_dim, gl.tile_dim);
+	glUniform1f(gl.uniform_line_width, gl.line_width);
+	glUniform1i(gl.uniform_hovered, gl.hovered < gl.state.size() ? (GLint)gl.hovered : -1);
+	glUniform4fv(gl.uniform_colors, 8, &gl.palette[0].x);
+	glUniform4fv(gl.uniform_line_color, 1, &gl.lines.x);
+	glUniform4fv(gl.uniform_glyphs, 8, &gl.glyph_boxes[0].x);
+	glUniform4fv(gl.uniform_glyph_uvs, 8, &gl.glyph_uvs[0].x);
+	glBindVertexArray(gl.vertex_array);
+	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+}
@@ -0,0 +1,154 @@
+﻿// minesweeper_gl.h : the board drawn by one fragment shader from a texture holding a byte per tile, so a frame
+// costs the same for any board size. the gl side lives in minesweeper_gl.cpp because it goes through the
+// imgui backend's loader, which can't share a translation unit with glew.
+
+#pragma once
+
+#include "imgui/imgui.h"
+#include "minesweeper.h"
+#include "minesweeper_mesh.h"
+#include <vector>
+#include <cstdint>
+
+// the byte uploaded per tile, only what the player can see
+enum class minesweeper_gl_state : uint8_t {
+	nearby = 0x0f, // revealed tiles only
+	hidden = 0x10,
+	flagged = 0x20,
+	mine = 0x40, // revealed mines only
+};
+
+struct minesweeper_gl_t {
+	bool ready = false; // the shader compiled, otherwise keep drawing with the mesh
+	uint32_t program = 0;
+	uint32_t vertex_array = 0;
+	uint32_t texture = 0;
+	int32_t max_texture_size = 0;
+
+	// uniform locations
+	int32_t uniform_proj_mtx = -1;
+	int32_t uniform_rect = -1;
+	int32_t uniform_board = -1;
+	int32_t uniform_font = -1;
+	int32_t uniform_origin = -1;
+	int32_t uniform_tile_dim = -1;
+	int32_t uniform_line_width = -1;
+	int32_t uniform_hovered = -1;
+	int32_t uniform_colors = -1;
+	int32_t uniform_line_color = -1;
+	int32_t uniform_glyphs = -1;
+	int32_t uniform_glyph_uvs = -1;
+
+	// board as uploaded, rows first_row to last_row still have to go to the texture
+	uint32_t x_tiles = 0;
+	uint32_t y_tiles = 0;
+	std::vector<uint8_t> state;
+	std::vector<uint32_t> dirty; // rows whose bytes may be stale
+	uint32_t first_row = 1;
+	uint32_t last_row = 0;
+	uint32_t texture_x = 0;
+	uint32_t texture_y = 0;
+	bool valid = false;
+
+	// what the shader needs for this frame
+	ImVec2 origin = {};
+	float tile_dim = 0.0f;
+	float line_width = 0.0f;
+	uint32_t hovered = ~uint32_t{ 0 };
+	ImVec4 palette[8] = {}; // hidden, revealed, flagged, mine, then the same hovered
+	ImVec4 lines = {};
+	ImVec4 glyph_boxes[8] = {}; // digits 1 to 8 relative to the floored tile center, as AddText places them
+	ImVec4 glyph_uvs[8] = {};
+	uint32_t font_texture = 0;
+};
+
+inline uint8_t minesweeper_gl_state_byte(const mine& m) {
+	uint8_t state = 0;
+	if (is_hidden(m))
+		state |= (uint8_t)minesweeper_gl_state::hidden;
+	else
+		state |= (uint8_t)(m.nearby & (uint16_t)minesweeper_gl_state::nearby);
+	if (is_flagged(m))
+		state |= (uint8_t)minesweeper_gl_state::flagged;
+	if (is_mine(m) && !is_hidden(m))
+		state |= (uint8_t)minesweeper_gl_state::mine;
+	return state;
+}
+
+// compiles the shader, false when the context is too old for it (glsl below 130 or es 2)
+bool minesweeper_gl_init(minesweeper_gl_t& gl, const char* glsl_version);
+void minesweeper_gl_shutdown(minesweeper_gl_t& gl);
+// ImDrawCallback, uploads the stale rows and draws the board quad
+void minesweeper_gl_render(const ImDrawList* parent_list, const ImDrawCmd* cmd);
+
+// the next update rebuilds every byte
+inline void minesweeper_gl_invalidate(minesweeper_gl_t& gl) {
+	gl.valid = false;
+}
+
+inline void minesweeper_gl_touch(minesweeper_gl_t& gl, uint32_t tile) {
+	if (gl.x_tiles)
+		gl.dirty.emplace_back(tile / gl.x_tiles);
+}
+
+// rows as left by minesweeper_reveal_rows
+inline void minesweeper_gl_touch_rows(minesweeper_gl_t& gl, const std::vector<uint32_t>& rows) {
+	gl.dirty.insert(gl.dirty.end(), rows.begin(), rows.end());
+}
+
+// whether the board fits in one texture
+inline bool minesweeper_gl_fits(const minesweeper_gl_t& gl, uint32_t x_tiles, uint32_t y_tiles) {
+	return gl.ready && x_tiles <= (uint32_t)gl.max_texture_size && y_tiles <= (uint32_t)gl.max_texture_size;
+}
+
+// brings the bytes and the frame's uniforms up to date, the upload itself waits for the render callback
+inline void minesweeper_gl_update(minesweeper_gl_t& gl, const std::vector<mine>& tiles, const minesweeper_palette_t& palette, const minesweeper_digits_t& digits, uint32_t x_tiles, uint32_t y_tiles, float tile_dim, ImVec2 origin, float line_width, uint32_t hovered) {
+	if (!gl.valid || gl.x_tiles != x_tiles || gl.y_tiles != y_tiles || gl.state.size() != tiles.size()) {
+		gl.x_tiles = x_tiles;
+		gl.y_tiles = y_tiles;
+		gl.state.resize(tiles.size());
+		for (size_t i = 0; i < tiles.size(); i++)
+			gl.state[i] = minesweeper_gl_state_byte(tiles[i]);
+		gl.dirty.clear();
+		gl.first_row = 0;
+		gl.last_row = y_tiles ? y_tiles - 1 : 0;
+		gl.valid = true;
+	}
+	for (uint32_t row : gl.dirty) {
+		if (row >= y_tiles)
+			continue;
+		for (size_t i = size_t{ row } * x_tiles; i < size_t{ row + 1 } * x_tiles; i++)
+			gl.state[i] = minesweeper_gl_state_byte(tiles[i]);
+		if (gl.first_row > gl.last_row) {
+			gl.first_row = row;
+			gl.last_row = row;
+		}
+		else {
+			gl.first_row = std::min(gl.first_row, row);
+			gl.last_row = std::max(gl.last_row, row);
+		}
+	}
+	gl.dirty.clear();
+
+	gl.origin = origin;
+	gl.tile_dim = tile_dim;
+	gl.line_width = line_width;
+	gl.hovered = hovered;
+	const ImU32 colors[8] = { palette.gray, palette.dark_gray, palette.red, palette.black, palette.hover_gray, palette.hover_dark_gray, palette.hover_red, palette.hover_black };
+	for (size_t i = 0; i < 8; i++)
+		gl.palette[i] = ImGui::ColorConvertU32ToFloat4(colors[i]);
+	gl.lines = ImGui::ColorConvertU32ToFloat4(palette.dark_gray);
+
+	// the same glyphs the mesh path draws
+	for (size_t i = 0; i < 8; i++) {
+		gl.glyph_boxes[i] = digits.visible[i] ? digits.boxes[i] : ImVec4{};
+		gl.glyph_uvs[i] = digits.uvs[i];
+	}
+	gl.font_texture = (uint32_t)(intptr_t)ImGui::GetIO().Fonts->TexID;
+}
+
+// the board in one quad, the backend's own state is restored right after
+inline void minesweeper_gl_draw(ImDrawList* draw_list, minesweeper_gl_t& gl) {
+	draw_list->AddCallback(minesweeper_gl_render, &gl);
+	draw_list->AddCallback(ImDrawCallback_ResetRenderState, nullptr);
+}
@@ -0,0 +1,329 @@
+﻿// minesweeper_guess.h : picks the tile to guess when nothing is provably safe, by looking a few guesses ahead
+// over boards sampled from the probability solver.
+
+#pragma once
+
+#include "minesweeper_solver.h"
+#include "minesweeper_hash.h"
+#include "thread_pool.h"
+#include "chacha.h"
+
+struct minesweeper_guess_config_t {
+	uint32_t candidates = 8; // lowest risk tiles compared at the root
+	uint32_t samples = 32; // boards sampled per root candidate
+	uint32_t depth = 2; // guesses looked ahead, counting the root guess
+	uint32_t inner_candidates = 3; // same, for guesses further down the tree
+	uint32_t inner_samples = 4;
+	std::chrono::microseconds budget = std::chrono::milliseconds(100);
+	const std::atomic<bool>* cancel = nullptr; // optional, stops the search early like running out of time
+	bool parallel = true; // false keeps the search on the calling thread, for callers already parallel over games
+	bool random_ties = false; // equally good root tiles are ordered by the seed instead of by index, so replays differ
+};
+
+struct minesweeper_guess_t {
+	uint32_t tile = ~uint32_t{ 0 };
+	float mine_probability = 1.0f;
+	float win_probability = 0.0f; // estimated chance of clearing the board when guessing tile
+};
+
+inline uint32_t solver_random(chacha8r& rng, uint32_t range) {
+	uint32_t limit = (~uint32_t{ 0 } - (range - 1));
+	uint32_t limit_r = limit % range;
+
+	uint64_t m;
+	uint32_t l_value;
+	do {
+		m = uint64_t{ rng() } * uint64_t{ range };
+		l_value = uint32_t(m);
+	} while (l_value < limit_r); // discard out of bounds
+
+	return m >> 32;
+}
+
+// draws one full board consistent with the visible state, every consistent board equally likely.
+// e must come from minesweeper_exact_build on the same solver and tiles.
+inline void minesweeper_exact_sample(const solver_exact_t& e, const minesweeper_solver_t& solver, const std::vector<mine>& tiles, uint32_t x_tiles, uint32_t y_tiles, chacha8r& rng, std::vector<mine>& board, std::vector<uint32_t>& free_tiles) {
+	board.assign(tiles.begin(), tiles.end());
+	free_tiles.clear();
+	for (size_t i = 0; i < board.size(); i++) {
+		board[i].flags &= ~(uint16_t)mine_flag::mine;
+		if (solver.marks[i] == (uint8_t)solver_mark::mine)
+			board[i].flags |= (uint16_t)mine_flag::mine;
+		else if (solver.marks[i] == (uint8_t)solver_mark::unknown && solver.column[i] == ~uint32_t{ 0 })
+			free_tiles.emplace_back(i);
+	}
+
+	// walk the memoized tree, taking each branch in proportion to the boards below it
+	uint32_t node = 0;
+	uint32_t placed = 0;
+	for (uint32_t pos = 0; pos < e.cells; pos++) {
+		std::array<double, 2> w = { 0.0, 0.0 };
+		for (uint32_t v = 0; v < 2; v++) {
+			uint32_t child = e.nodes[node].child[v];
+			if (child == ~uint32_t{ 0 })
+				continue;
+			const std::vector<double>& suffix = e.nodes[child].suffix;
+			for (size_t q = 0; q < suffix.size(); q++)
+				w[v] += suffix[q] * e.weight[placed + v + q];
+		}
+		double roll = (rng() * (1.0 / 4294967296.0)) * (w[0] + w[1]);
+		uint32_t v = (roll >= w[0] && w[1] > 0.0) || w[0] <= 0.0;
+		node = e.nodes[node].child[v];
+		placed += v;
+		if (v)
+			board[e.tile[pos]].flags |= (uint16_t)mine_flag::mine;
+	}
+
+	// the rest go uniformly into tiles no number touches
+	int64_t rest = std::clamp<int64_t>(e.mines_left - placed, 0, free_tiles.size());
+	for (int64_t i = 0; i < rest; i++) {
+		uint32_t pick = i + solver_random(rng, free_tiles.size() - i);
+		std::swap(free_tiles[i], free_tiles[pick]);
+		board[free_tiles[i]].flags |= (uint16_t)mine_flag::mine;
+	}
+	minesweeper_neighbors_2d(board, x_tiles, y_tiles);
+}
+
+// clicks every tile the solver proves safe until it gets stuck, true once only mines are left hidden.
+// zobrist (optional) is kept in sync with board through every reveal.
+inline bool minesweeper_guess_progress(minesweeper_solver_t& solver, std::vector<mine>& board, std::vector<uint32_t>& idxs, uint32_t x_tiles, uint32_t y_tiles, uint64_t mine_count, minesweeper_zobrist_t* zobrist = nullptr, std::vector<uint32_t>* rows = nullptr) {
+	for (;;) {
+		size_t hidden = 0;
+		for (size_t i = 0; i < board.size(); i++)
+			hidden += is_hidden(board[i]);
+		if (hidden <= mine_count)
+			return true;
+
+		minesweeper_solve(solver, board, x_tiles, y_tiles, mine_count);
+		size_t clicked = 0;
+		for (uint32_t tile : solver.safe) {
+			if (is_hidden(board[tile])) {
+				minesweeper_reveal(board, idxs, x_tiles, y_tiles, tile);
+				if (zobrist)
+					minesweeper_zobrist_update_reveal(*zobrist, board, idxs, *rows, x_tiles, y_tiles);
+				clicked++;
+			}
+		}
+		if (!clicked)
+			return false;
+	}
+}
+
+// lowest risk undecided tiles first, ties go to tiles with fewer unknown neighbors (corners and edges open up more)
+// ties (non zero) salts the order of tiles that are equally good, 0 keeps them in index order
+inline void minesweeper_guess_candidates(const minesweeper_solver_t& solver, uint32_t x_tiles, uint32_t y_tiles, uint32_t count, std::vector<uint32_t>& candidates, uint64_t ties = 0) {
+	candidates.clear();
+	for (size_t i = 0; i < solver.marks.size(); i++) {
+		if (solver.marks[i] == (uint8_t)solver_mark::unknown)
+			candidates.emplace_back(i);
+	}
+	auto unknown_neighbors = [&](uint32_t tile) {
+		int x = tile % x_tiles;
+		int y = tile / x_tiles;
+		uint32_t n = 0;
+		for (size_t o = 0; o < solver_offsets.size(); o++) {
+			int nx = x + solver_offsets[o].x;
+			int ny = y + solver_offsets[o].y;
+			n += nx >= 0 && ny >= 0 && nx < (int)x_tiles && ny < (int)y_tiles && solver.marks[ny * x_tiles + nx] == (uint8_t)solver_mark::unknown;
+		}
+		return n;
+	};
+	auto better = [&](uint32_t a, uint32_t b) {
+		if (solver.probability[a] != solver.probability[b])
+			return solver.probability[a] < solver.probability[b];
+		uint32_t na = unknown_neighbors(a);
+		uint32_t nb = unknown_neighbors(b);
+		if (na != nb)
+			return na < nb;
+		return ties ? zobrist_mix(a ^ ties) < zobrist_mix(b ^ ties) : a < b;
+	};
+	count = std::min<uint32_t>(count, candidates.size());
+	std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(), better);
+	candidates.resize(count);
+}
+
+struct minesweeper_guess_scratch_t {
+	std::vector<minesweeper_solver_t> solver; // one per level of the search
+	std::vector<solver_exact_t> exact;
+	std::vector<std::vector<mine>> board;
+	std::vector<minesweeper_zobrist_t> zobrist; // hash of board at the same level
+	std::vector<uint32_t> idxs;
+	std::vector<uint32_t> rows;
+	std::vector<uint32_t> free_tiles;
+	std::vector<uint32_t> candidates;
+};
+
+struct minesweeper_guess_context_t {
+	uint32_t x_tiles = 0;
+	uint32_t y_tiles = 0;
+	uint64_t mine_count = 0;
+	minesweeper_guess_config_t config;
+	std::chrono::steady_clock::time_point deadline;
+	minesweeper_transposition_t* table = nullptr;
+};
+
+// a position's value depends on how much look ahead is left below it, and on the board it is on: the hint
+// engine keeps one table across every board dealt, and the same visible tiles with another mine count or
+// another width are a different position
+inline uint64_t minesweeper_guess_key(const minesweeper_guess_context_t& ctx, const minesweeper_guess_scratch_t& s, uint32_t level) {
+	uint64_t board = zobrist_mix(zobrist_mix(ctx.mine_count << 32 | ctx.x_tiles) ^ ctx.y_tiles);
+	return s.zobrist[level].hash ^ board ^ zobrist_mix(~uint64_t{ 0 } - (ctx.config.depth - level));
+}
+
+inline bool minesweeper_guess_expired(const minesweeper_guess_context_t& ctx) {
+	return std::chrono::steady_clock::now() > ctx.deadline || (ctx.config.cancel && ctx.config.cancel->load(std::memory_order_relaxed));
+}
+
+// expected chance of winning from a stuck position (solver[level] has just run on board) when guessing optimally.
+// past the look ahead depth the chance of surviving the next guess stands in for the rest of the game.
+inline double minesweeper_guess_position(const minesweeper_guess_context_t& ctx, minesweeper_guess_scratch_t& s, uint32_t level, chacha8r& rng) {
+	minesweeper_solver_t& solver = s.solver[level];
+	solver_exact_t& e = s.exact[level];
+	const std::vector<mine>& board = s.board[level];
+
+	// boards sampled for different candidates often reveal into the same position
+	float cached;
+	uint64_t key = minesweeper_guess_key(ctx, s, level);
+	if (ctx.table && minesweeper_transposition_probe(*ctx.table, key, cached))
+		return cached;
+
+	// the model is only needed to sample the next level
+	bool exact = minesweeper_solve_probabilities(solver, e, board, ctx.x_tiles, ctx.y_tiles, ctx.mine_count, level < ctx.config.depth) == solver_probabilities::model;
+	float lowest = 1.0f;
+	for (size_t i = 0; i < board.size(); i++) {
+		if (solver.marks[i] == (uint8_t)solver_mark::unknown)
+			lowest = std::min(lowest, solver.probability[i]);
+	}
+	bool expired = minesweeper_guess_expired(ctx);
+	if (!exact || level >= ctx.config.depth || expired) {
+		// a search cut short isn't worth remembering under this depth
+		if (ctx.table && !expired)
+			minesweeper_transposition_store(*ctx.table, key, 1.0f - lowest);
+		return 1.0 - lowest;
+	}
+
+	std::vector<uint32_t> candidates;
+	minesweeper_guess_candidates(solver, ctx.x_tiles, ctx.y_tiles, ctx.config.inner_candidates, candidates);
+
+	double best = 1.0 - lowest;
+	for (uint32_t c : candidates) {
+		double sum = 0.0;
+		uint32_t count = 0;
+		for (uint32_t i = 0; i < ctx.config.inner_samples && !minesweeper_guess_expired(ctx); i++) {
+			std::vector<mine>& next = s.board[level + 1];
+			minesweeper_exact_sample(e, solver, board, ctx.x_tiles, ctx.y_tiles, rng, next, s.free_tiles);
+			if (is_mine(next[c]))
+				continue;
+			minesweeper_zobrist_t& z = s.zobrist[level + 1];
+			z = s.zobrist[level];
+			minesweeper_reveal(next, s.idxs, ctx.x_tiles, ctx.y_tiles, c);
+			minesweeper_zobrist_update_reveal(z, next, s.idxs, s.rows, ctx.x_tiles, ctx.y_tiles);
+			bool won = minesweeper_guess_progress(s.solver[level + 1], next, s.idxs, ctx.x_tiles, ctx.y_tiles, ctx.mine_count, &z, &s.rows);
+			sum += won ? 1.0 : minesweeper_guess_position(ctx, s, level + 1, rng);
+			count++;
+		}
+		if (count)
+			best = std::max(best, (1.0 - solver.probability[c]) * (sum / count));
+	}
+	if (ctx.table && !minesweeper_guess_expired(ctx))
+		minesweeper_transposition_store(*ctx.table, key, (float)best);
+	return best;
+}
+
+// bounded depth expectimax over the lowest risk tiles. each (candidate, sample) pair is a task on the pool,
+// samples still pending when the time budget runs out are dropped and the estimate uses what finished.
+// table (optional) caches position values by zobrist hash and may be shared between searches and threads.
+inline minesweeper_guess_t minesweeper_guess(thread_pool_t& pool, const std::vector<mine>& tiles, uint32_t x_tiles, uint32_t y_tiles, uint64_t mine_count, const minesweeper_guess_config_t& config, uint64_t seed, minesweeper_transposition_t* table = nullptr) {
+	minesweeper_guess_context_t ctx = { x_tiles, y_tiles, mine_count, config, std::chrono::steady_clock::now() + config.budget, table };
+	minesweeper_guess_t guess = {};
+
+	minesweeper_solver_t solver;
+	solver_exact_t e;
+	minesweeper_solve(solver, tiles, x_tiles, y_tiles, mine_count);
+	for (uint32_t tile : solver.safe) {
+		if (is_hidden(tiles[tile]))
+			return { tile, 0.0f, 1.0f };
+	}
+
+	bool search = config.depth > 1 && config.samples;
+	bool exact = minesweeper_solve_probabilities(solver, e, tiles, x_tiles, y_tiles, mine_count, search) == solver_probabilities::model;
+	std::vector<uint32_t> candidates;
+	minesweeper_guess_candidates(solver, x_tiles, y_tiles, config.candidates, candidates, config.random_ties ? zobrist_mix(seed) | 1 : 0);
+	if (candidates.empty())
+		return guess;
+
+	guess.tile = candidates[0];
+	guess.mine_probability = solver.probability[candidates[0]];
+	guess.win_probability = 1.0f - guess.mine_probability;
+	if (!exact || !search || candidates.size() == 1)
+		return guess;
+
+	struct result_t {
+		uint8_t done = 0;
+		uint8_t safe = 0;
+		double value = 0.0;
+	};
+	std::vector<result_t> results(candidates.size() * config.samples);
+	minesweeper_zobrist_t root;
+	minesweeper_zobrist_reset(root, tiles);
+	std::vector<minesweeper_guess_scratch_t> scratch(config.parallel ? pool.size() + 1 : 1);
+	for (minesweeper_guess_scratch_t& s : scratch) {
+		s.solver.resize(config.depth + 1);
+		s.exact.resize(config.depth + 1);
+		s.board.resize(config.depth + 1);
+		s.zobrist.resize(config.depth + 1);
+	}
+
+	auto evaluate = [&](size_t task, size_t worker) {
+		if (minesweeper_guess_expired(ctx))
+			return;
+		minesweeper_guess_scratch_t& s = scratch[worker];
+		chacha8r rng(seed, task);
+		uint32_t c = candidates[task / config.samples];
+
+		std::vector<mine>& board = s.board[1];
+		minesweeper_exact_sample(e, solver, tiles, x_tiles, y_tiles, rng, board, s.free_tiles);
+		result_t& r = results[task];
+		r.done = 1;
+		if (is_mine(board[c]))
+			return;
+		r.safe = 1;
+		minesweeper_zobrist_t& z = s.zobrist[1];
+		z = root;
+		minesweeper_reveal(board, s.idxs, x_tiles, y_tiles, c);
+		minesweeper_zobrist_update_reveal(z, board, s.idxs, s.rows, x_tiles, y_tiles);
+		bool won = minesweeper_guess_progress(s.solver[1], board, s.idxs, x_tiles, y_tiles, mine_count, &z, &s.rows);
+		r.value = won ? 1.0 : minesweeper_guess_position(ctx, s, 1, rng);
+	};
+	if (config.parallel) {
+		parallel_for(pool, 0, results.size(), 1, evaluate);
+	}
+	else {
+		for (size_t task = 0; task < results.size(); task++)
+			evaluate(task, 0);
+	}
+
+	double best = -1.0;
+	for (size_t i = 0; i < candidates.size(); i++) {
+		double sum = 0.0;
+		uint32_t safe = 0;
+		uint32_t done = 0;
+		for (size_t j = 0; j < config.samples; j++) {
+			const result_t& r = results[i * config.samples + j];
+			done += r.done;
+			safe += r.safe;
+			sum += r.value;
+		}
+		if (!done)
+			continue;
+		double p = solver.probability[candidates[i]];
+		double value = safe ? (1.0 - p) * (sum / safe) : 0.0;
+		if (value > best) {
+			best = value;
+			guess.tile = candidates[i];
+			guess.mine_probability = p;
+			guess.win_probability = value;
+		}
+	}
+	return guess;
+}
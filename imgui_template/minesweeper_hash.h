@@ -0,0 +1,126 @@
+﻿// minesweeper_hash.h : zobrist hashing of the player visible board and a lock free transposition table
+// for caching position evaluations across solver threads.
+
+#pragma once
+
+#include "minesweeper.h"
+#include <atomic>
+#include <memory>
+
+constexpr uint64_t zobrist_mix(uint64_t x) {
+	x += 0x9e3779b97f4a7c15;
+	x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+	x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+	return x ^ (x >> 31);
+}
+
+// hidden, hidden + flagged, then revealed with 0 - 8 mines nearby
+constexpr uint8_t minesweeper_visible_state(const mine& m) noexcept {
+	return is_hidden(m) ? (uint8_t)is_flagged(m) : (uint8_t)(2 + m.nearby);
+}
+
+// keys are derived from (tile, state) instead of stored, a table of 11 keys per tile gets large on huge boards
+constexpr uint64_t minesweeper_zobrist_key(uint32_t tile, uint8_t state) noexcept {
+	return zobrist_mix((uint64_t{ tile } << 4) | state);
+}
+
+struct minesweeper_zobrist_t {
+	uint64_t hash = 0;
+	std::vector<uint8_t> state; // visible state each tile was hashed with
+};
+
+inline void minesweeper_zobrist_reset(minesweeper_zobrist_t& z, const std::vector<mine>& tiles) {
+	z.hash = 0;
+	z.state.resize(tiles.size());
+	for (size_t i = 0; i < tiles.size(); i++) {
+		z.state[i] = minesweeper_visible_state(tiles[i]);
+		z.hash ^= minesweeper_zobrist_key(i, z.state[i]);
+	}
+}
+
+// after flagging / unflagging a tile
+inline void minesweeper_zobrist_update(minesweeper_zobrist_t& z, const std::vector<mine>& tiles, uint32_t tile) {
+	uint8_t state = minesweeper_visible_state(tiles[tile]);
+	if (state == z.state[tile])
+		return;
+	z.hash ^= minesweeper_zobrist_key(tile, z.state[tile]) ^ minesweeper_zobrist_key(tile, state);
+	z.state[tile] = state;
+}
+
+// after minesweeper_reveal, idxs as it left them. only the rows the flood fill could reach are rehashed.
+inline void minesweeper_zobrist_update_reveal(minesweeper_zobrist_t& z, const std::vector<mine>& tiles, const std::vector<uint32_t>& idxs, std::vector<uint32_t>& rows, uint32_t x_tiles, uint32_t y_tiles) {
+	minesweeper_reveal_rows(idxs, x_tiles, y_tiles, rows);
+	for (uint32_t row : rows) {
+		for (uint32_t tile = row * x_tiles; tile < (row + 1) * x_tiles; tile++)
+			minesweeper_zobrist_update(z, tiles, tile);
+	}
+}
+
+struct minesweeper_transposition_stats_t {
+	uint64_t probes = 0;
+	uint64_t hits = 0;
+	uint64_t stores = 0;
+	double hit_rate = 0.0;
+};
+
+// fixed size, always replace. each slot keeps (key ^ data, data) so a torn write from two threads storing
+// at once fails the key check on the next probe instead of returning the wrong position's value.
+struct minesweeper_transposition_t {
+	struct entry_t {
+		std::atomic<uint64_t> check = { 0 };
+		std::atomic<uint64_t> data = { 0 };
+	};
+
+	std::unique_ptr<entry_t[]> entries;
+	uint64_t mask = 0;
+	std::atomic<uint64_t> probes = { 0 };
+	std::atomic<uint64_t> hits = { 0 };
+	std::atomic<uint64_t> stores = { 0 };
+
+	explicit minesweeper_transposition_t(uint32_t log2_entries = 20)
+		: entries(new entry_t[size_t{ 1 } << log2_entries]), mask((uint64_t{ 1 } << log2_entries) - 1) {
+	}
+};
+
+inline bool minesweeper_transposition_probe(minesweeper_transposition_t& table, uint64_t key, float& value) {
+	table.probes.fetch_add(1, std::memory_order_relaxed);
+	minesweeper_transposition_t::entry_t& entry = table.entries[key & table.mask];
+	uint64_t data = entry.data.load(std::memory_order_relaxed);
+	uint64_t check = entry.check.load(std::memory_order_relaxed);
+	// the top bit marks a used slot, so an empty slot never matches key 0
+	if ((check ^ data) != key || !(data >> 63))
+		return false;
+	uint32_t bits = uint32_t(data);
+	std::memcpy(&value, &bits, sizeof(value));
+	table.hits.fetch_add(1, std::memory_order_relaxed);
+	return true;
+}
+
+inline void minesweeper_transposition_store(minesweeper_transposition_t& table, uint64_t key, float value) {
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	uint64_t data = (uint64_t{ 1 } << 63) | bits;
+	minesweeper_transposition_t::entry_t& entry = table.entries[key & table.mask];
+	entry.check.store(key ^ data, std::memory_order_relaxed);
+	entry.data.store(data, std::memory_order_relaxed);
+	table.stores.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline minesweeper_transposition_stats_t minesweeper_transposition_stats(const minesweeper_transposition_t& table) {
+	minesweeper_transposition_stats_t stats;
+	stats.probes = table.probes.load(std::memory_order_relaxed);
+	stats.hits = table.hits.load(std::memory_order_relaxed);
+	stats.stores = table.stores.load(std::memory_order_relaxed);
+	stats.hit_rate = stats.probes ? double(stats.hits) / double(stats.probes) : 0.0;
+	return stats;
+}
+
+// what happened between two reads of the counters, for tables that outlive one measurement
+inline minesweeper_transposition_stats_t minesweeper_transposition_delta(const minesweeper_transposition_stats_t& now, const minesweeper_transposition_stats_t& then) {
+	minesweeper_transposition_stats_t stats;
+	stats.probes = now.probes - then.probes;
+	stats.hits = now.hits - then.hits;
+	stats.stores = now.stores - then.stores;
+	stats.hit_rate = stats.probes ? double(stats.hits) / double(stats.probes) : 0.0;
+	return stats;
+}
@@ -0,0 +1,177 @@
+﻿// minesweeper_hint.h : background hint engine. the frame loop hands it immutable snapshots of the visible
+// board and reads back the best answer found so far without ever waiting on the solver.
+
+#pragma once
+
+#include "minesweeper_guess.h"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+enum class hint_kind : uint8_t {
+	none = 0,
+	safe = 1, // provably safe tile
+	guess = 2, // best guess found so far
+};
+
+struct minesweeper_hint_snapshot_t {
+	std::vector<mine> tiles; // visible state only, mines and hidden numbers stripped
+	uint32_t x_tiles = 0;
+	uint32_t y_tiles = 0;
+	uint64_t mine_count = 0;
+	uint64_t hash = 0;
+};
+
+struct minesweeper_hint_t {
+	uint32_t generation = 0;
+	hint_kind kind = hint_kind::none;
+	uint32_t tile = ~uint32_t{ 0 };
+};
+
+// (generation:24, kind:8, tile:32) so the result is one lock free atomic word
+constexpr uint64_t minesweeper_hint_pack(uint32_t generation, hint_kind kind, uint32_t tile) {
+	return (uint64_t{ generation & 0xffffff } << 40) | (uint64_t{ (uint8_t)kind } << 32) | tile;
+}
+
+constexpr minesweeper_hint_t minesweeper_hint_unpack(uint64_t packed) {
+	return { uint32_t(packed >> 40), (hint_kind)(uint8_t)(packed >> 32), uint32_t(packed) };
+}
+
+struct minesweeper_hint_engine_t {
+	thread_pool_t pool;
+	minesweeper_transposition_t table;
+
+	std::mutex lock;
+	std::condition_variable wake;
+	std::shared_ptr<const minesweeper_hint_snapshot_t> pending; // handed over under lock, newest wins
+	bool stopping = false;
+
+	std::atomic<uint32_t> generation = { 0 }; // bumped for every snapshot and every cancel
+	std::atomic<bool> cancel = { false };
+	std::atomic<uint64_t> result = { 0 };
+	void (*notify)() = nullptr; // called on the worker after each published answer, set before the first submit
+
+
+	std::thread worker;
+
+	explicit minesweeper_hint_engine_t(size_t threads = std::max<size_t>(std::thread::hardware_concurrency(), 2) - 1)
+		: pool(threads), table(18), worker([this] { run(); }) {
+	}
+
+	~minesweeper_hint_engine_t() {
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			stopping = true;
+			cancel = true;
+		}
+		wake.notify_one();
+		worker.join();
+	}
+
+	minesweeper_hint_engine_t(const minesweeper_hint_engine_t&) = delete;
+	minesweeper_hint_engine_t& operator=(const minesweeper_hint_engine_t&) = delete;
+
+	void publish(uint32_t gen, hint_kind kind, uint32_t tile) {
+		// a newer snapshot or a cancel makes this answer stale, leave whatever is there
+		if (generation.load(std::memory_order_acquire) != gen)
+			return;
+		result.store(minesweeper_hint_pack(gen, kind, tile), std::memory_order_release);
+		if (notify)
+			notify();
+	}
+
+	void run() {
+		for (;;) {
+			std::shared_ptr<const minesweeper_hint_snapshot_t> snapshot;
+			uint32_t gen;
+			{
+				std::unique_lock<std::mutex> guard(lock);
+				wake.wait(guard, [this] { return stopping || pending; });
+				if (stopping)
+					return;
+				snapshot = std::move(pending);
+				pending.reset();
+				gen = generation.load(std::memory_order_acquire);
+				cancel = false;
+			}
+			analyze(*snapshot, gen);
+		}
+	}
+
+	// anytime: publish the first answer as fast as possible, then keep refining it until cancelled
+	void analyze(const minesweeper_hint_snapshot_t& s, uint32_t gen) {
+		minesweeper_solver_t solver;
+		solver_exact_t e;
+		minesweeper_solve(solver, s.tiles, s.x_tiles, s.y_tiles, s.mine_count);
+		for (uint32_t tile : solver.safe) {
+			if (is_hidden(s.tiles[tile])) {
+				publish(gen, hint_kind::safe, tile);
+				return;
+			}
+		}
+		if (cancel)
+			return;
+
+		std::vector<uint32_t> candidates;
+		minesweeper_solve_probabilities(solver, e, s.tiles, s.x_tiles, s.y_tiles, s.mine_count, false);
+		minesweeper_guess_candidates(solver, s.x_tiles, s.y_tiles, 1, candidates);
+		if (candidates.empty())
+			return;
+		publish(gen, hint_kind::guess, candidates[0]);
+
+		// deepen the look ahead with growing budgets
+		std::array<minesweeper_guess_config_t, 3> passes = {};
+		passes[0].depth = 1;
+		passes[0].budget = std::chrono::milliseconds(30);
+		passes[1].depth = 2;
+		passes[1].budget = std::chrono::milliseconds(250);
+		passes[2].depth = 3;
+		passes[2].samples = 64;
+		passes[2].budget = std::chrono::milliseconds(1500);
+		for (size_t i = 0; i < passes.size() && !cancel; i++) {
+			passes[i].cancel = &cancel;
+			minesweeper_guess_t guess = minesweeper_guess(pool, s.tiles, s.x_tiles, s.y_tiles, s.mine_count, passes[i], s.hash + i, &table);
+			if (cancel || guess.tile == ~uint32_t{ 0 })
+				return;
+			publish(gen, guess.mine_probability == 0.0f ? hint_kind::safe : hint_kind::guess, guess.tile);
+		}
+	}
+};
+
+// drops whatever is being analyzed, the current hint disappears until the next snapshot is solved
+inline void minesweeper_hint_cancel(minesweeper_hint_engine_t& engine) {
+	std::lock_guard<std::mutex> guard(engine.lock);
+	engine.generation.fetch_add(1, std::memory_order_acq_rel);
+	engine.cancel = true;
+	engine.pending.reset();
+}
+
+// copies the visible part of the board, the worker never sees where the mines are
+inline void minesweeper_hint_submit(minesweeper_hint_engine_t& engine, const std::vector<mine>& tiles, uint32_t x_tiles, uint32_t y_tiles, uint64_t mine_count, uint64_t hash) {
+	std::shared_ptr<minesweeper_hint_snapshot_t> snapshot = std::make_shared<minesweeper_hint_snapshot_t>();
+	snapshot->tiles.resize(tiles.size());
+	for (size_t i = 0; i < tiles.size(); i++) {
+		snapshot->tiles[i].flags = tiles[i].flags & ~(uint16_t)mine_flag::mine;
+		snapshot->tiles[i].nearby = is_hidden(tiles[i]) ? 0 : tiles[i].nearby;
+	}
+	snapshot->x_tiles = x_tiles;
+	snapshot->y_tiles = y_tiles;
+	snapshot->mine_count = mine_count;
+	snapshot->hash = hash;
+
+	{
+		std::lock_guard<std::mutex> guard(engine.lock);
+		engine.generation.fetch_add(1, std::memory_order_acq_rel);
+		engine.cancel = true;
+		engine.pending = std::move(snapshot);
+	}
+	engine.wake.notify_one();
+}
+
+// lock free, safe to call every frame. kind is none until an answer for the latest snapshot exists.
+inline minesweeper_hint_t minesweeper_hint_current(const minesweeper_hint_engine_t& engine) {
+	minesweeper_hint_t hint = minesweeper_hint_unpack(engine.result.load(std::memory_order_acquire));
+	if (hint.generation != (engine.generation.load(std::memory_order_acquire) & 0xffffff))
+		hint.kind = hint_kind::none;
+	return hint;
+}
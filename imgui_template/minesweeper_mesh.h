@@ -0,0 +1,296 @@
+﻿// minesweeper_mesh.h : the visible part of the board as a prebuilt imgui mesh. tile quads only have their colors
+// patched when a tile changes and the whole block is copied into the window draw list each frame, instead of one
+// AddRectFilled per tile and one AddLine per grid line. panning or zooming rebuilds it for the new range. digits
+// are written straight into the draw list from glyphs looked up once, instead of one AddText per tile.
+
+#pragma once
+
+#include "imgui/imgui.h"
+#include "minesweeper.h"
+#include "minesweeper_camera.h"
+#include <vector>
+#include <cstring>
+
+struct minesweeper_palette_t {
+	ImU32 gray = ImU32{ 0xffc1c0c1 };
+	ImU32 dark_gray = ImU32{ 0xff4d4d4d };
+	ImU32 red = ImU32{ 0xff2828f2 };
+	ImU32 black = ImU32{ 0xff030303 };
+
+	ImU32 hover_gray = ImU32{ 0xffc9c8c9 };
+	ImU32 hover_dark_gray = ImU32{ 0xff4d4d4d };
+	ImU32 hover_red = ImU32{ 0xff2828f2 };
+	ImU32 hover_black = ImU32{ 0xff090909 };
+};
+
+inline ImU32 minesweeper_tile_color(const minesweeper_palette_t& palette, const mine& m, bool hovered) {
+	if (is_mine(m) && !is_hidden(m))
+		return hovered ? palette.hover_black : palette.black;
+	if (is_flagged(m) && is_hidden(m))
+		return hovered ? palette.hover_red : palette.red;
+	if (is_hidden(m))
+		return hovered ? palette.hover_gray : palette.gray;
+	return hovered ? palette.hover_dark_gray : palette.dark_gray;
+}
+
+// zoomed out further the quads for the visible tiles get too many to rebuild while panning
+constexpr float minesweeper_mesh_min_tile = 4.0f;
+
+// indices are relative to the first vertex of the chunk, so a chunk can land anywhere in a draw list
+struct minesweeper_mesh_chunk_t {
+	std::vector<ImDrawVert> vtx;
+	std::vector<ImDrawIdx> idx;
+};
+
+struct minesweeper_mesh_t {
+	uint32_t x_tiles = 0;
+	uint32_t y_tiles = 0;
+	float tile_dim = 0.0f;
+	ImVec2 origin = {};
+	minesweeper_tile_range_t range; // the only tiles in the mesh
+	uint32_t rows_per_chunk = 1; // tile quads are split in row bands that fit 16 bit indices
+	std::vector<minesweeper_mesh_chunk_t> chunks;
+	minesweeper_mesh_chunk_t lines;
+	uint32_t hovered = ~uint32_t{ 0 };
+	std::vector<uint32_t> dirty; // tiles whose color may be stale
+	std::vector<uint8_t> numbered; // per tile in range, already in numbers
+	std::vector<uint32_t> numbers; // revealed tiles in range with a number to draw
+	bool valid = false;
+	size_t patched = 0; // tiles recolored by the last update
+};
+
+// the next update rebuilds everything
+inline void minesweeper_mesh_invalidate(minesweeper_mesh_t& mesh) {
+	mesh.valid = false;
+}
+
+inline void minesweeper_mesh_touch(minesweeper_mesh_t& mesh, uint32_t tile) {
+	mesh.dirty.emplace_back(tile);
+}
+
+// rows as left by minesweeper_reveal_rows, only the part in range
+inline void minesweeper_mesh_touch_rows(minesweeper_mesh_t& mesh, const std::vector<uint32_t>& rows) {
+	for (uint32_t row : rows) {
+		if (row < mesh.range.y0 || row >= mesh.range.y1)
+			continue;
+		for (uint32_t x = mesh.range.x0; x < mesh.range.x1; x++)
+			mesh.dirty.emplace_back(row * mesh.x_tiles + x);
+	}
+}
+
+inline bool minesweeper_mesh_in_range(const minesweeper_mesh_t& mesh, uint32_t tile) {
+	uint32_t x = tile % mesh.x_tiles;
+	uint32_t y = tile / mesh.x_tiles;
+	return x >= mesh.range.x0 && x < mesh.range.x1 && y >= mesh.range.y0 && y < mesh.range.y1;
+}
+
+inline void minesweeper_mesh_copy(minesweeper_mesh_chunk_t& chunk, const ImDrawList& list) {
+	chunk.vtx.assign(list.VtxBuffer.Data, list.VtxBuffer.Data + list.VtxBuffer.Size);
+	chunk.idx.assign(list.IdxBuffer.Data, list.IdxBuffer.Data + list.IdxBuffer.Size);
+}
+
+inline void minesweeper_mesh_build(minesweeper_mesh_t& mesh, const std::vector<mine>& tiles, const minesweeper_palette_t& palette, uint32_t x_tiles, uint32_t y_tiles, minesweeper_tile_range_t range, float tile_dim, ImVec2 origin, float line_width) {
+	mesh.x_tiles = x_tiles;
+	mesh.y_tiles = y_tiles;
+	mesh.tile_dim = tile_dim;
+	mesh.origin = origin;
+	mesh.range = range;
+	uint32_t columns = range.x1 - range.x0;
+	uint32_t rows = range.y1 - range.y0;
+	mesh.rows_per_chunk = std::max<uint32_t>(1, 65535 / (4 * std::max<uint32_t>(columns, 1)));
+	mesh.chunks.resize((rows + mesh.rows_per_chunk - 1) / mesh.rows_per_chunk);
+	mesh.dirty.clear();
+	mesh.numbered.assign(size_t{ columns } * rows, 0);
+	mesh.numbers.clear();
+	mesh.valid = true;
+
+	// same quads AddRectFilled makes: corners clockwise from the top left, two triangles
+	ImVec2 uv = ImGui::GetIO().Fonts->TexUvWhitePixel;
+	for (uint32_t c = 0; c < mesh.chunks.size(); c++) {
+		minesweeper_mesh_chunk_t& chunk = mesh.chunks[c];
+		uint32_t first_row = c * mesh.rows_per_chunk;
+		uint32_t chunk_rows = std::min(mesh.rows_per_chunk, rows - first_row);
+		chunk.vtx.resize(size_t{ chunk_rows } * columns * 4);
+		chunk.idx.resize(size_t{ chunk_rows } * columns * 6);
+		for (uint32_t q = 0; q < chunk_rows * columns; q++) {
+			uint32_t local = first_row * columns + q;
+			uint32_t x = range.x0 + local % columns;
+			uint32_t y = range.y0 + local / columns;
+			uint32_t tile = y * x_tiles + x;
+			ImVec2 a = { origin.x + (float)x * tile_dim, origin.y + (float)y * tile_dim };
+			ImVec2 b = { a.x + tile_dim, a.y + tile_dim };
+			ImU32 col = minesweeper_tile_color(palette, tiles[tile], tile == mesh.hovered);
+			if (!is_hidden(tiles[tile]) && is_near_mine(tiles[tile])) {
+				mesh.numbered[local] = 1;
+				mesh.numbers.emplace_back(tile);
+			}
+			ImDrawVert* v = &chunk.vtx[size_t{ q } * 4];
+			v[0] = { a, uv, col };
+			v[1] = { ImVec2{ b.x, a.y }, uv, col };
+			v[2] = { b, uv, col };
+			v[3] = { ImVec2{ a.x, b.y }, uv, col };
+			ImDrawIdx* i = &chunk.idx[size_t{ q } * 6];
+			ImDrawIdx base = (ImDrawIdx)(q * 4);
+			i[0] = base;
+			i[1] = base + 1;
+			i[2] = base + 2;
+			i[3] = base;
+			i[4] = base + 2;
+			i[5] = base + 3;
+		}
+	}
+
+	// anti aliased lines are more involved, let imgui build them once into a scratch list and keep the result
+	ImDrawList scratch(ImGui::GetDrawListSharedData());
+	scratch._ResetForNewFrame();
+	float top = origin.y + (float)range.y0 * tile_dim;
+	float bottom = origin.y + (float)range.y1 * tile_dim;
+	float left = origin.x + (float)range.x0 * tile_dim;
+	float right = origin.x + (float)range.x1 * tile_dim;
+	for (uint32_t i = range.x0; i < range.x1 + 1 && rows; i++)
+		scratch.AddLine(ImVec2{ origin.x + (float)i * tile_dim, top }, ImVec2{ origin.x + (float)i * tile_dim, bottom }, palette.dark_gray, line_width);
+	for (uint32_t i = range.y0; i < range.y1 + 1 && columns; i++)
+		scratch.AddLine(ImVec2{ left, origin.y + (float)i * tile_dim }, ImVec2{ right, origin.y + (float)i * tile_dim }, palette.dark_gray, line_width);
+	minesweeper_mesh_copy(mesh.lines, scratch);
+}
+
+// brings the mesh up to date with the board, rebuilding only when the layout or the visible range changed
+inline void minesweeper_mesh_update(minesweeper_mesh_t& mesh, const std::vector<mine>& tiles, const minesweeper_palette_t& palette, uint32_t x_tiles, uint32_t y_tiles, minesweeper_tile_range_t range, float tile_dim, ImVec2 origin, float line_width, uint32_t hovered) {
+	mesh.patched = 0;
+	if (hovered != mesh.hovered) {
+		if (mesh.hovered < tiles.size())
+			mesh.dirty.emplace_back(mesh.hovered);
+		if (hovered < tiles.size())
+			mesh.dirty.emplace_back(hovered);
+		mesh.hovered = hovered;
+	}
+	bool same = mesh.valid && mesh.x_tiles == x_tiles && mesh.y_tiles == y_tiles && mesh.tile_dim == tile_dim && mesh.origin.x == origin.x && mesh.origin.y == origin.y && mesh.range == range;
+	if (!same || tiles.size() != size_t{ x_tiles } * y_tiles) {
+		minesweeper_mesh_build(mesh, tiles, palette, x_tiles, y_tiles, range, tile_dim, origin, line_width);
+		mesh.patched = size_t{ range.x1 - range.x0 } * (range.y1 - range.y0);
+		return;
+	}
+
+	uint32_t columns = range.x1 - range.x0;
+	for (uint32_t tile : mesh.dirty) {
+		if (tile >= tiles.size() || !minesweeper_mesh_in_range(mesh, tile))
+			continue;
+		uint32_t local = (tile / x_tiles - range.y0) * columns + (tile % x_tiles - range.x0);
+		uint32_t c = local / columns / mesh.rows_per_chunk;
+		ImDrawVert* v = &mesh.chunks[c].vtx[size_t{ local - c * mesh.rows_per_chunk * columns } * 4];
+		ImU32 col = minesweeper_tile_color(palette, tiles[tile], tile == mesh.hovered);
+		v[0].col = col;
+		v[1].col = col;
+		v[2].col = col;
+		v[3].col = col;
+		if (!mesh.numbered[local] && !is_hidden(tiles[tile]) && is_near_mine(tiles[tile])) {
+			mesh.numbered[local] = 1;
+			mesh.numbers.emplace_back(tile);
+		}
+	}
+	mesh.patched = mesh.dirty.size();
+	mesh.dirty.clear();
+}
+
+inline void minesweeper_mesh_emit(ImDrawList* draw_list, const minesweeper_mesh_chunk_t& chunk) {
+	if (chunk.idx.empty())
+		return;
+	draw_list->PrimReserve((int)chunk.idx.size(), (int)chunk.vtx.size());
+	std::memcpy(draw_list->_VtxWritePtr, chunk.vtx.data(), chunk.vtx.size() * sizeof(ImDrawVert));
+	ImDrawIdx base = (ImDrawIdx)draw_list->_VtxCurrentIdx;
+	for (size_t i = 0; i < chunk.idx.size(); i++)
+		draw_list->_IdxWritePtr[i] = chunk.idx[i] + base;
+	draw_list->_VtxWritePtr += chunk.vtx.size();
+	draw_list->_IdxWritePtr += chunk.idx.size();
+	draw_list->_VtxCurrentIdx += (unsigned int)chunk.vtx.size();
+}
+
+// one reservation per chunk
+inline void minesweeper_mesh_draw_tiles(ImDrawList* draw_list, const minesweeper_mesh_t& mesh) {
+	for (const minesweeper_mesh_chunk_t& chunk : mesh.chunks)
+		minesweeper_mesh_emit(draw_list, chunk);
+}
+
+inline void minesweeper_mesh_draw_lines(ImDrawList* draw_list, const minesweeper_mesh_t& mesh) {
+	minesweeper_mesh_emit(draw_list, mesh.lines);
+}
+
+// digits 1 to 8 as AddText draws them, looked up again only when the font changes instead of once per tile
+struct minesweeper_digits_t {
+	const ImFont* font = nullptr;
+	float size = 0.0f;
+	ImVec4 boxes[8] = {}; // relative to the floored text position, already scaled
+	ImVec4 uvs[8] = {};
+	bool visible[8] = {};
+	bool colored[8] = {};
+};
+
+inline void minesweeper_digits_update(minesweeper_digits_t& digits, const ImFont* font, float size) {
+	if (digits.font == font && digits.size == size)
+		return;
+	digits.font = font;
+	digits.size = size;
+	float scale = size / font->FontSize;
+	for (size_t i = 0; i < 8; i++) {
+		const ImFontGlyph* glyph = font->FindGlyph((ImWchar)('1' + i));
+		digits.visible[i] = glyph && glyph->Visible;
+		digits.colored[i] = glyph && glyph->Colored;
+		digits.boxes[i] = glyph ? ImVec4{ glyph->X0 * scale, glyph->Y0 * scale, glyph->X1 * scale, glyph->Y1 * scale } : ImVec4{};
+		digits.uvs[i] = glyph ? ImVec4{ glyph->U0, glyph->V0, glyph->U1, glyph->V1 } : ImVec4{};
+	}
+}
+
+// the digit of every tile in numbers with one reservation per batch, placed and culled the way AddText would
+// at the tile center. the draw list has to have the font atlas bound, as AddText also asserts
+inline void minesweeper_digits_draw(ImDrawList* draw_list, const minesweeper_digits_t& digits, const std::vector<mine>& tiles, const std::vector<uint32_t>& numbers, uint32_t x_tiles, float tile_dim, ImVec2 origin, ImU32 col) {
+	if ((col & IM_COL32_A_MASK) == 0 || !x_tiles)
+		return;
+	ImVec2 clip_min = draw_list->GetClipRectMin();
+	ImVec2 clip_max = draw_list->GetClipRectMax();
+	ImU32 col_untinted = col | ~IM_COL32_A_MASK;
+	// a batch stays inside 16 bit indices
+	constexpr size_t batch = 65536 / 4 - 1;
+	for (size_t first = 0; first < numbers.size(); first += batch) {
+		size_t count = std::min(batch, numbers.size() - first);
+		draw_list->PrimReserve((int)count * 6, (int)count * 4);
+		ImDrawVert* vtx_write = draw_list->_VtxWritePtr;
+		ImDrawIdx* idx_write = draw_list->_IdxWritePtr;
+		ImDrawIdx vtx_current = (ImDrawIdx)draw_list->_VtxCurrentIdx;
+		size_t drawn = 0;
+		for (size_t n = first; n < first + count; n++) {
+			uint32_t i = numbers[n];
+			uint32_t d = (uint32_t)tiles[i].nearby - 1;
+			if (d >= 8 || !digits.visible[d])
+				continue;
+			// truncated like IM_FLOOR
+			float x = (float)(int)(origin.x + ((float)(i % x_tiles) + 0.5f) * tile_dim);
+			float y = (float)(int)(origin.y + ((float)(i / x_tiles) + 0.5f) * tile_dim);
+			if (y > clip_max.y || y + digits.size < clip_min.y)
+				continue;
+			const ImVec4& box = digits.boxes[d];
+			if (x + box.x > clip_max.x || x + box.z < clip_min.x)
+				continue;
+			// what PrimRectUV writes, without a call per digit
+			const ImVec4& uv = digits.uvs[d];
+			ImU32 glyph_col = digits.colored[d] ? col_untinted : col;
+			vtx_write[0] = { ImVec2{ x + box.x, y + box.y }, ImVec2{ uv.x, uv.y }, glyph_col };
+			vtx_write[1] = { ImVec2{ x + box.z, y + box.y }, ImVec2{ uv.z, uv.y }, glyph_col };
+			vtx_write[2] = { ImVec2{ x + box.z, y + box.w }, ImVec2{ uv.z, uv.w }, glyph_col };
+			vtx_write[3] = { ImVec2{ x + box.x, y + box.w }, ImVec2{ uv.x, uv.w }, glyph_col };
+			idx_write[0] = vtx_current;
+			idx_write[1] = vtx_current + 1;
+			idx_write[2] = vtx_current + 2;
+			idx_write[3] = vtx_current;
+			idx_write[4] = vtx_current + 2;
+			idx_write[5] = vtx_current + 3;
+			vtx_write += 4;
+			idx_write += 6;
+			vtx_current += 4;
+			drawn++;
+		}
+		draw_list->_VtxWritePtr = vtx_write;
+		draw_list->_IdxWritePtr = idx_write;
+		draw_list->_VtxCurrentIdx += (unsigned int)drawn * 4;
+		draw_list->PrimUnreserve((int)(count - drawn) * 6, (int)(count - drawn) * 4);
+	}
+}
@@ -0,0 +1,91 @@
+﻿// minesweeper_minimap.cpp : texture uploads for minesweeper_minimap.h, built on the backend's loader.
+//
+
+#include "minesweeper_minimap.h"
+#include "imgui/imgui_impl_opengl3_loader.h"
+#include <algorithm>
+
+// enough rows for about a million texels per upload
+static constexpr size_t minesweeper_minimap_band = size_t{ 1 } << 20;
+
+bool minesweeper_minimap_init(minesweeper_minimap_t& minimap) {
+	GLint last_texture = 0;
+	glGetIntegerv(GL_TEXTURE_BINDING_2D, &last_texture);
+	glGenTextures(1, &minimap.texture);
+	glBindTexture(GL_TEXTURE_2D, minimap.texture);
+	// whole tiles while zoomed in, a blend of neighbours once several share a pixel
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glBindTexture(GL_TEXTURE_2D, last_texture);
+	glGetIntegerv(GL_MAX_TEXTURE_SIZE, &minimap.max_texture_size);
+	minimap.x_tiles = 0;
+	minimap.y_tiles = 0;
+	minimap.valid = false;
+	minimap.ready = minimap.texture != 0;
+	return minimap.ready;
+}
+
+void minesweeper_minimap_shutdown(minesweeper_minimap_t& minimap) {
+	if (minimap.texture)
+		glDeleteTextures(1, &minimap.texture);
+	minimap.texture = 0;
+	minimap.ready = false;
+}
+
+// rows [y0, y1) in bands, so a board of a hundred million tiles never needs a copy of itself
+static void minesweeper_minimap_upload(minesweeper_minimap_t& minimap, const std::vector<mine>& tiles, const minesweeper_palette_t& palette, uint32_t y0, uint32_t y1) {
+	uint32_t x_tiles = minimap.x_tiles;
+	uint32_t band = (uint32_t)std::max<size_t>(minesweeper_minimap_band / x_tiles, 1);
+	for (uint32_t y = y0; y < y1; y += band) {
+		uint32_t rows = std::min(band, y1 - y);
+		minimap.pixels.resize(size_t{ rows } * x_tiles);
+		const mine* row = tiles.data() + size_t{ y } * x_tiles;
+		for (size_t i = 0; i < minimap.pixels.size(); i++)
+			minimap.pixels[i] = minesweeper_tile_color(palette, row[i], false);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, y, x_tiles, rows, GL_RGBA, GL_UNSIGNED_BYTE, minimap.pixels.data());
+	}
+	minimap.uploaded += y1 - y0;
+}
+
+void minesweeper_minimap_update(minesweeper_minimap_t& minimap, const std::vector<mine>& tiles, const minesweeper_palette_t& palette, uint32_t x_tiles, uint32_t y_tiles) {
+	minimap.uploaded = 0;
+	if (!minimap.ready || !x_tiles || !y_tiles || tiles.size() != size_t{ x_tiles } * y_tiles)
+		return;
+	bool resize = minimap.x_tiles != x_tiles || minimap.y_tiles != y_tiles;
+	if (minimap.valid && !resize && minimap.dirty.empty())
+		return;
+
+	GLint last_texture = 0;
+	GLint last_alignment = 0;
+	glGetIntegerv(GL_TEXTURE_BINDING_2D, &last_texture);
+	glGetIntegerv(GL_UNPACK_ALIGNMENT, &last_alignment);
+	glBindTexture(GL_TEXTURE_2D, minimap.texture);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+	if (resize) {
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, x_tiles, y_tiles, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+		minimap.x_tiles = x_tiles;
+		minimap.y_tiles = y_tiles;
+	}
+	if (!minimap.valid || resize) {
+		minesweeper_minimap_upload(minimap, tiles, palette, 0, y_tiles);
+		minimap.valid = true;
+	}
+	else {
+		// runs of neighbouring rows go up together, a flood fill is usually one run
+		std::sort(minimap.dirty.begin(), minimap.dirty.end());
+		minimap.dirty.erase(std::unique(minimap.dirty.begin(), minimap.dirty.end()), minimap.dirty.end());
+		for (size_t i = 0; i < minimap.dirty.size() && minimap.dirty[i] < y_tiles;) {
+			size_t j = i + 1;
+			while (j < minimap.dirty.size() && minimap.dirty[j] == minimap.dirty[j - 1] + 1 && minimap.dirty[j] < y_tiles)
+				j++;
+			minesweeper_minimap_upload(minimap, tiles, palette, minimap.dirty[i], minimap.dirty[j - 1] + 1);
+			i = j;
+		}
+	}
+	minimap.dirty.clear();
+	glPixelStorei(GL_UNPACK_ALIGNMENT, last_alignment);
+	glBindTexture(GL_TEXTURE_2D, last_texture);
+}
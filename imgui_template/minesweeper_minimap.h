@@ -0,0 +1,64 @@
+﻿// minesweeper_minimap.h : the board as a texture with one texel per tile, drawn as a single image once tiles get
+// too small to tell apart. it follows every change whatever renderer is on screen, so zooming out never has to
+// rebuild it, and only rows touched since the last frame are sent to the gpu. the gl side is in
+// minesweeper_minimap.cpp, next to minesweeper_gl.cpp and for the same reason.
+
+#pragma once
+
+#include "imgui/imgui.h"
+#include "minesweeper.h"
+#include "minesweeper_mesh.h"
+#include "minesweeper_camera.h"
+#include <vector>
+#include <cstdint>
+
+// below this the minimap replaces tiles, digits and lines, and the mesh never has to go smaller
+constexpr float minesweeper_minimap_max_tile = minesweeper_mesh_min_tile;
+
+struct minesweeper_minimap_t {
+	bool ready = false; // the texture exists
+	uint32_t texture = 0;
+	int32_t max_texture_size = 0;
+
+	uint32_t x_tiles = 0;
+	uint32_t y_tiles = 0;
+	std::vector<uint32_t> dirty; // rows whose texels may be stale
+	std::vector<ImU32> pixels; // a band of rows on their way to the texture, never the whole board
+	bool valid = false;
+	size_t uploaded = 0; // rows sent by the last update
+};
+
+bool minesweeper_minimap_init(minesweeper_minimap_t& minimap);
+void minesweeper_minimap_shutdown(minesweeper_minimap_t& minimap);
+// sends the stale rows, every row after a new board
+void minesweeper_minimap_update(minesweeper_minimap_t& minimap, const std::vector<mine>& tiles, const minesweeper_palette_t& palette, uint32_t x_tiles, uint32_t y_tiles);
+
+// the next update resends every row
+inline void minesweeper_minimap_invalidate(minesweeper_minimap_t& minimap) {
+	minimap.valid = false;
+}
+
+inline void minesweeper_minimap_touch(minesweeper_minimap_t& minimap, uint32_t tile) {
+	if (minimap.x_tiles)
+		minimap.dirty.emplace_back(tile / minimap.x_tiles);
+}
+
+// rows as left by minesweeper_reveal_rows
+inline void minesweeper_minimap_touch_rows(minesweeper_minimap_t& minimap, const std::vector<uint32_t>& rows) {
+	minimap.dirty.insert(minimap.dirty.end(), rows.begin(), rows.end());
+}
+
+// whether the board fits in one texture
+inline bool minesweeper_minimap_fits(const minesweeper_minimap_t& minimap, uint32_t x_tiles, uint32_t y_tiles) {
+	return minimap.ready && x_tiles <= (uint32_t)minimap.max_texture_size && y_tiles <= (uint32_t)minimap.max_texture_size;
+}
+
+// the whole board in one quad, plus the hovered tile on top
+inline void minesweeper_minimap_draw(ImDrawList* draw_list, const minesweeper_minimap_t& minimap, const std::vector<mine>& tiles, const minesweeper_palette_t& palette, const minesweeper_camera_t& camera, uint32_t hovered) {
+	draw_list->AddImage((ImTextureID)(intptr_t)minimap.texture, camera.origin, minesweeper_camera_board_max(camera, minimap.x_tiles, minimap.y_tiles));
+	if (hovered < tiles.size() && minimap.x_tiles) {
+		ImVec2 top_left = { camera.origin.x + (float)(hovered % minimap.x_tiles) * camera.tile_dim, camera.origin.y + (float)(hovered / minimap.x_tiles) * camera.tile_dim };
+		ImVec2 btm_right = { top_left.x + camera.tile_dim, top_left.y + camera.tile_dim };
+		draw_list->AddRectFilled(top_left, btm_right, minesweeper_tile_color(palette, tiles[hovered], true));
+	}
+}
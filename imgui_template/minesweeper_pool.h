@@ -0,0 +1,195 @@
+﻿// minesweeper_pool.h : canonical hashing of mine layouts up to rotation / reflection and a concurrent set for
+// dropping duplicate boards while a pool is built on many threads.
+
+#pragma once
+
+#include "minesweeper_hash.h"
+#include <thread>
+
+// mine bitplane, rows[y * words + x / 64] bit x % 64
+struct minesweeper_bitboard_t {
+	uint32_t x_tiles = 0;
+	uint32_t y_tiles = 0;
+	uint32_t words = 0;
+	std::vector<uint64_t> rows;
+};
+
+inline void minesweeper_bitboard_resize(minesweeper_bitboard_t& b, uint32_t x_tiles, uint32_t y_tiles) {
+	b.x_tiles = x_tiles;
+	b.y_tiles = y_tiles;
+	b.words = (x_tiles + 63) / 64;
+	b.rows.assign(size_t{ b.words } * y_tiles, 0);
+}
+
+inline void minesweeper_bitboard_from(minesweeper_bitboard_t& b, const std::vector<mine>& tiles, uint32_t x_tiles, uint32_t y_tiles) {
+	minesweeper_bitboard_resize(b, x_tiles, y_tiles);
+	for (uint32_t y = 0; y < y_tiles; y++) {
+		for (uint32_t x = 0; x < x_tiles; x++)
+			b.rows[y * b.words + x / 64] |= uint64_t{ is_mine(tiles[y * x_tiles + x]) } << (x % 64);
+	}
+}
+
+constexpr uint64_t bit_reverse64(uint64_t v) {
+	v = ((v >> 1) & 0x5555555555555555) | ((v & 0x5555555555555555) << 1);
+	v = ((v >> 2) & 0x3333333333333333) | ((v & 0x3333333333333333) << 2);
+	v = ((v >> 4) & 0x0f0f0f0f0f0f0f0f) | ((v & 0x0f0f0f0f0f0f0f0f) << 4);
+	v = ((v >> 8) & 0x00ff00ff00ff00ff) | ((v & 0x00ff00ff00ff00ff) << 8);
+	v = ((v >> 16) & 0x0000ffff0000ffff) | ((v & 0x0000ffff0000ffff) << 16);
+	return (v >> 32) | (v << 32);
+}
+
+// 64x64 bit matrix transpose in place, a[i] bit j swaps with a[j] bit i. six rounds of block swaps instead of
+// 4096 single bit moves.
+inline void bit_transpose64(uint64_t* a) {
+	uint64_t m = 0x00000000ffffffff;
+	for (uint32_t j = 32; j != 0; j >>= 1, m ^= (m << j)) {
+		for (uint32_t k = 0; k < 64; k = ((k | j) + 1) & ~j) {
+			uint64_t t = ((a[k] >> j) ^ a[k | j]) & m;
+			a[k] ^= t << j;
+			a[k | j] ^= t;
+		}
+	}
+}
+
+// mirror left to right
+inline void minesweeper_bitboard_flip_x(const minesweeper_bitboard_t& src, minesweeper_bitboard_t& dst) {
+	minesweeper_bitboard_resize(dst, src.x_tiles, src.y_tiles);
+	uint32_t pad = src.words * 64 - src.x_tiles;
+	for (uint32_t y = 0; y < src.y_tiles; y++) {
+		const uint64_t* in = &src.rows[size_t{ y } * src.words];
+		uint64_t* out = &dst.rows[size_t{ y } * dst.words];
+		// reversing the whole padded row leaves the pad at the bottom, shift it back out
+		for (uint32_t w = 0; w < src.words; w++) {
+			uint64_t lo = bit_reverse64(in[src.words - 1 - w]);
+			uint64_t hi = w + 1 < src.words ? bit_reverse64(in[src.words - 2 - w]) : 0;
+			out[w] = pad ? (lo >> pad) | (hi << (64 - pad)) : lo;
+		}
+	}
+}
+
+// mirror top to bottom
+inline void minesweeper_bitboard_flip_y(const minesweeper_bitboard_t& src, minesweeper_bitboard_t& dst) {
+	minesweeper_bitboard_resize(dst, src.x_tiles, src.y_tiles);
+	for (uint32_t y = 0; y < src.y_tiles; y++)
+		std::copy_n(&src.rows[size_t{ src.y_tiles - 1 - y } * src.words], src.words, &dst.rows[size_t{ y } * dst.words]);
+}
+
+// swap x and y, 64x64 blocks at a time
+inline void minesweeper_bitboard_transpose(const minesweeper_bitboard_t& src, minesweeper_bitboard_t& dst) {
+	minesweeper_bitboard_resize(dst, src.y_tiles, src.x_tiles);
+	std::array<uint64_t, 64> block;
+	for (uint32_t by = 0; by < (src.y_tiles + 63) / 64; by++) {
+		for (uint32_t bx = 0; bx < src.words; bx++) {
+			for (uint32_t i = 0; i < 64; i++) {
+				uint32_t y = by * 64 + i;
+				block[i] = y < src.y_tiles ? src.rows[size_t{ y } * src.words + bx] : 0;
+			}
+			bit_transpose64(block.data());
+			for (uint32_t i = 0; i < 64; i++) {
+				uint32_t y = bx * 64 + i;
+				if (y < dst.y_tiles)
+					dst.rows[size_t{ y } * dst.words + by] = block[i];
+			}
+		}
+	}
+}
+
+struct minesweeper_board_key_t {
+	uint64_t lo = 0;
+	uint64_t hi = 0;
+};
+
+constexpr bool operator<(const minesweeper_board_key_t& a, const minesweeper_board_key_t& b) {
+	return a.hi != b.hi ? a.hi < b.hi : a.lo < b.lo;
+}
+
+constexpr bool operator==(const minesweeper_board_key_t& a, const minesweeper_board_key_t& b) {
+	return a.hi == b.hi && a.lo == b.lo;
+}
+
+// 128 bits so millions of boards never collide in practice
+inline minesweeper_board_key_t minesweeper_bitboard_key(const minesweeper_bitboard_t& b) {
+	minesweeper_board_key_t key = { zobrist_mix((uint64_t{ b.x_tiles } << 32) | b.y_tiles), zobrist_mix(~((uint64_t{ b.y_tiles } << 32) | b.x_tiles)) };
+	for (uint64_t word : b.rows) {
+		key.lo = zobrist_mix(key.lo ^ word);
+		key.hi = zobrist_mix(key.hi + word);
+	}
+	return key;
+}
+
+struct minesweeper_canonical_scratch_t {
+	minesweeper_bitboard_t board;
+	std::array<minesweeper_bitboard_t, 3> flipped; // x, y, both (half turn)
+};
+
+// the same key for a layout and all of its rotations / reflections: 8 of them on square boards, 4 otherwise
+// (a quarter turn of a non square board has a different shape). the smallest key of the group is used.
+inline minesweeper_board_key_t minesweeper_canonical_key(minesweeper_canonical_scratch_t& s, const std::vector<mine>& tiles, uint32_t x_tiles, uint32_t y_tiles) {
+	minesweeper_board_key_t best = {};
+	bool first = true;
+	uint32_t passes = x_tiles == y_tiles ? 2 : 1;
+	for (uint32_t pass = 0; pass < passes; pass++) {
+		if (!pass)
+			minesweeper_bitboard_from(s.board, tiles, x_tiles, y_tiles);
+		else
+			minesweeper_bitboard_transpose(s.flipped[2], s.board); // half turn then transposed, its flips are the other four
+		minesweeper_bitboard_flip_x(s.board, s.flipped[0]);
+		minesweeper_bitboard_flip_y(s.board, s.flipped[1]);
+		minesweeper_bitboard_flip_y(s.flipped[0], s.flipped[2]);
+		for (const minesweeper_bitboard_t* b : { &s.board, &s.flipped[0], &s.flipped[1], &s.flipped[2] }) {
+			minesweeper_board_key_t key = minesweeper_bitboard_key(*b);
+			if (first || key < best)
+				best = key;
+			first = false;
+		}
+	}
+	return best;
+}
+
+// fixed capacity open addressing set of board keys, lock free. a slot is claimed by its lo word, hi follows
+// right after, so a probe that finds lo but not hi yet waits for it.
+struct minesweeper_board_set_t {
+	struct slot_t {
+		std::atomic<uint64_t> lo = { 0 };
+		std::atomic<uint64_t> hi = { 0 };
+	};
+
+	std::unique_ptr<slot_t[]> slots;
+	uint64_t mask = 0;
+	std::atomic<uint64_t> size = { 0 };
+
+	// room for at least capacity keys at under half load
+	explicit minesweeper_board_set_t(uint64_t capacity) {
+		uint64_t n = 16;
+		while (n < capacity * 2)
+			n <<= 1;
+		slots.reset(new slot_t[n]);
+		mask = n - 1;
+	}
+};
+
+// true if key wasn't in the set yet. keys are forced non zero, zero marks an empty slot.
+inline bool minesweeper_board_set_insert(minesweeper_board_set_t& set, minesweeper_board_key_t key) {
+	key.lo |= 1;
+	key.hi |= 1;
+	for (uint64_t i = key.lo >> 1, probes = 0; probes <= set.mask; i++, probes++) {
+		minesweeper_board_set_t::slot_t& slot = set.slots[i & set.mask];
+		uint64_t lo = slot.lo.load(std::memory_order_acquire);
+		if (!lo) {
+			if (slot.lo.compare_exchange_strong(lo, key.lo, std::memory_order_acq_rel)) {
+				slot.hi.store(key.hi, std::memory_order_release);
+				set.size.fetch_add(1, std::memory_order_relaxed);
+				return true;
+			}
+			// someone else claimed it first, lo now holds their key
+		}
+		if (lo != key.lo)
+			continue;
+		uint64_t hi;
+		while (!(hi = slot.hi.load(std::memory_order_acquire)))
+			std::this_thread::yield();
+		if (hi == key.hi)
+			return false;
+	}
+	return false; // full, treated as a duplicate so callers never overrun the pool
+}
@@ -0,0 +1,186 @@
+﻿// minesweeper_profile.h : where each frame's time goes. one scoped timer per frame is moved from phase to phase
+// through the main loop and hands the finished frame to a ring buffer when it goes out of scope. the ring is
+// written by the frame loop only and read without locks, by the overlay or by a dump at exit.
+
+#pragma once
+
+#include "imgui/imgui.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+enum class frame_phase : uint8_t {
+	wait = 0, // blocked in glfwWaitEventsTimeout, not part of the frame's own cost
+	poll,
+	new_frame,
+	update, // camera, hover, clicks and reveals
+	draw, // the board into the draw list
+	scan, // win/loss recount
+	overlay, // this profiler's own window
+	render, // ImGui::Render
+	render_draw_data, // ImGui_ImplOpenGL3_RenderDrawData
+	swap,
+	count,
+};
+
+constexpr const char* frame_phase_names[(size_t)frame_phase::count] = {
+	"wait", "poll", "new frame", "update", "draw", "scan", "overlay", "render", "render draw data", "swap",
+};
+
+struct frame_sample_t {
+	float ms[(size_t)frame_phase::count] = {};
+	float busy = 0.0f; // everything but wait
+};
+
+struct minesweeper_profile_t {
+	static constexpr size_t capacity = 512; // power of two
+	std::array<frame_sample_t, capacity> frames = {};
+	std::atomic<uint64_t> written = { 0 }; // frames ever committed, the newest is at written - 1
+	bool show = false;
+};
+
+// a reader can trail the writer by up to capacity - 1 frames before slots get reused under it
+inline void minesweeper_profile_commit(minesweeper_profile_t& profile, const frame_sample_t& sample) {
+	uint64_t n = profile.written.load(std::memory_order_relaxed);
+	profile.frames[n & (minesweeper_profile_t::capacity - 1)] = sample;
+	profile.written.store(n + 1, std::memory_order_release);
+}
+
+// times consecutive phases of one frame, commits it when it goes out of scope
+struct minesweeper_frame_timer_t {
+	using clock = std::chrono::steady_clock;
+
+	minesweeper_profile_t& profile;
+	frame_sample_t sample;
+	frame_phase phase;
+	clock::time_point start;
+
+	minesweeper_frame_timer_t(minesweeper_profile_t& profile, frame_phase phase)
+		: profile(profile), phase(phase), start(clock::now()) {
+	}
+
+	~minesweeper_frame_timer_t() {
+		next(frame_phase::count);
+		for (size_t i = 0; i < (size_t)frame_phase::count; i++)
+			sample.busy += i == (size_t)frame_phase::wait ? 0.0f : sample.ms[i];
+		minesweeper_profile_commit(profile, sample);
+	}
+
+	minesweeper_frame_timer_t(const minesweeper_frame_timer_t&) = delete;
+	minesweeper_frame_timer_t& operator=(const minesweeper_frame_timer_t&) = delete;
+
+	// closes the running phase and starts the given one, time spent twice in a phase adds up
+	void next(frame_phase to) {
+		clock::time_point now = clock::now();
+		if (phase < frame_phase::count)
+			sample.ms[(size_t)phase] += std::chrono::duration<float, std::milli>(now - start).count();
+		phase = to;
+		start = now;
+	}
+};
+
+struct minesweeper_profile_stats_t {
+	size_t frames = 0;
+	// per phase then busy
+	std::array<float, (size_t)frame_phase::count + 1> p50 = {};
+	std::array<float, (size_t)frame_phase::count + 1> p90 = {};
+	std::array<float, (size_t)frame_phase::count + 1> p99 = {};
+	std::array<float, (size_t)frame_phase::count + 1> max = {};
+};
+
+// percentiles over the frames still in the ring
+inline minesweeper_profile_stats_t minesweeper_profile_stats(const minesweeper_profile_t& profile) {
+	minesweeper_profile_stats_t stats;
+	uint64_t written = profile.written.load(std::memory_order_acquire);
+	stats.frames = (size_t)std::min<uint64_t>(written, minesweeper_profile_t::capacity);
+	if (!stats.frames)
+		return stats;
+	std::vector<float> values(stats.frames);
+	for (size_t p = 0; p < stats.p50.size(); p++) {
+		for (size_t i = 0; i < stats.frames; i++) {
+			const frame_sample_t& sample = profile.frames[(written - 1 - i) & (minesweeper_profile_t::capacity - 1)];
+			values[i] = p < (size_t)frame_phase::count ? sample.ms[p] : sample.busy;
+		}
+		std::sort(values.begin(), values.end());
+		auto at = [&](float q) { return values[std::min(stats.frames - 1, (size_t)(q * (float)stats.frames))]; };
+		stats.p50[p] = at(0.50f);
+		stats.p90[p] = at(0.90f);
+		stats.p99[p] = at(0.99f);
+		stats.max[p] = values.back();
+	}
+	return stats;
+}
+
+// a table of percentiles and a plot per phase, oldest frame on the left
+inline void minesweeper_profile_overlay(minesweeper_profile_t& profile) {
+	if (!profile.show)
+		return;
+	minesweeper_profile_stats_t stats = minesweeper_profile_stats(profile);
+	uint64_t written = profile.written.load(std::memory_order_acquire);
+	ImGui::SetNextWindowSize(ImVec2{ 520.0f, 0.0f }, ImGuiCond_FirstUseEver);
+	if (ImGui::Begin("frame timing", &profile.show)) {
+		ImGui::Text("%zu frames, ms", stats.frames);
+		if (ImGui::BeginTable("phases", 5, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp)) {
+			ImGui::TableSetupColumn("phase");
+			ImGui::TableSetupColumn("p50");
+			ImGui::TableSetupColumn("p90");
+			ImGui::TableSetupColumn("p99");
+			ImGui::TableSetupColumn("max");
+			ImGui::TableHeadersRow();
+			for (size_t p = 0; p < stats.p50.size(); p++) {
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn();
+				ImGui::TextUnformatted(p < (size_t)frame_phase::count ? frame_phase_names[p] : "busy");
+				ImGui::TableNextColumn();
+				ImGui::Text("%.3f", stats.p50[p]);
+				ImGui::TableNextColumn();
+				ImGui::Text("%.3f", stats.p90[p]);
+				ImGui::TableNextColumn();
+				ImGui::Text("%.3f", stats.p99[p]);
+				ImGui::TableNextColumn();
+				ImGui::Text("%.3f", stats.max[p]);
+			}
+			ImGui::EndTable();
+		}
+		// the ring is plotted in place, the offset starts it at the oldest frame
+		int count = (int)stats.frames;
+		int offset = written > minesweeper_profile_t::capacity ? (int)(written & (minesweeper_profile_t::capacity - 1)) : 0;
+		for (size_t p = 0; p < (size_t)frame_phase::count && count; p++) {
+			char overlay[48];
+			std::snprintf(overlay, sizeof(overlay), "%s p99 %.2f", frame_phase_names[p], stats.p99[p]);
+			ImGui::PlotLines(frame_phase_names[p], &profile.frames[0].ms[p], count, offset, overlay, 0.0f, std::max(stats.max[p], 0.001f), ImVec2{ 0.0f, 32.0f }, sizeof(frame_sample_t));
+		}
+		if (count)
+			ImGui::PlotLines("busy", &profile.frames[0].busy, count, offset, nullptr, 0.0f, std::max(stats.max[(size_t)frame_phase::count], 0.001f), ImVec2{ 0.0f, 48.0f }, sizeof(frame_sample_t));
+	}
+	ImGui::End();
+}
+
+// the frames still in the ring as csv, oldest first, then the percentiles
+inline void minesweeper_profile_dump(const minesweeper_profile_t& profile, FILE* out) {
+	uint64_t written = profile.written.load(std::memory_order_acquire);
+	uint64_t first = written > minesweeper_profile_t::capacity ? written - minesweeper_profile_t::capacity : 0;
+	std::fprintf(out, "frame");
+	for (const char* name : frame_phase_names)
+		std::fprintf(out, ",%s", name);
+	std::fprintf(out, ",busy\n");
+	for (uint64_t n = first; n < written; n++) {
+		const frame_sample_t& sample = profile.frames[n & (minesweeper_profile_t::capacity - 1)];
+		std::fprintf(out, "%llu", (unsigned long long)n);
+		for (float ms : sample.ms)
+			std::fprintf(out, ",%.4f", ms);
+		std::fprintf(out, ",%.4f\n", sample.busy);
+	}
+	minesweeper_profile_stats_t stats = minesweeper_profile_stats(profile);
+	const char* rows[4] = { "p50", "p90", "p99", "max" };
+	const std::array<float, (size_t)frame_phase::count + 1>* values[4] = { &stats.p50, &stats.p90, &stats.p99, &stats.max };
+	for (size_t r = 0; r < 4; r++) {
+		std::fprintf(out, "%s", rows[r]);
+		for (float ms : *values[r])
+			std::fprintf(out, ",%.4f", ms);
+		std::fprintf(out, "\n");
+	}
+}
@@ -0,0 +1,183 @@
+﻿// minesweeper_region.h : solves huge boards region by region on the thread pool. every region solves a window of
+// its tiles plus a halo of neighbors, certainties are exchanged between overlapping windows until no region finds
+// anything new, then one global pass picks up chains that cross regions and the endgame.
+
+#pragma once
+
+#include "minesweeper_solver.h"
+#include "thread_pool.h"
+
+struct minesweeper_region_config_t {
+	uint32_t width = 64; // owned tiles per region
+	uint32_t height = 64;
+	uint32_t halo = 4; // extra rows / columns of neighbors each window sees, pair patterns reach 2 tiles out
+};
+
+struct minesweeper_region_t {
+	uint32_t x0 = 0; // window, halo included and clipped to the board
+	uint32_t y0 = 0;
+	uint32_t x1 = 0;
+	uint32_t y1 = 0;
+	std::vector<uint32_t> safe; // board tiles decided by the last solve of this window
+	std::vector<uint32_t> mines;
+	uint32_t fresh = 0; // certainties the window gained in the last exchange
+	uint32_t own = 0; // how many of those came from its own solve
+};
+
+// one per pool worker
+struct minesweeper_region_scratch_t {
+	std::vector<mine> tiles;
+	minesweeper_solver_t solver;
+};
+
+struct minesweeper_regions_t {
+	minesweeper_region_config_t config;
+	uint32_t x_tiles = 0;
+	uint32_t y_tiles = 0;
+	uint32_t columns = 0;
+	uint32_t rows = 0;
+	std::vector<minesweeper_region_t> regions;
+	std::vector<uint32_t> pending; // windows that gained certainties they didn't find themselves
+	std::vector<minesweeper_region_scratch_t> scratch;
+	size_t rounds = 0; // exchange rounds of the last solve
+	size_t solves = 0; // region solves of the last solve
+};
+
+inline void minesweeper_regions_init(minesweeper_regions_t& r, uint32_t x_tiles, uint32_t y_tiles, size_t workers) {
+	minesweeper_region_config_t& c = r.config;
+	c.width = std::max<uint32_t>(c.width, 1);
+	c.height = std::max<uint32_t>(c.height, 1);
+	r.scratch.resize(workers);
+	if (r.x_tiles == x_tiles && r.y_tiles == y_tiles && r.regions.size())
+		return;
+	r.x_tiles = x_tiles;
+	r.y_tiles = y_tiles;
+	r.columns = (x_tiles + c.width - 1) / c.width;
+	r.rows = (y_tiles + c.height - 1) / c.height;
+	r.regions.assign(size_t{ r.columns } * r.rows, {});
+	for (uint32_t by = 0; by < r.rows; by++) {
+		for (uint32_t bx = 0; bx < r.columns; bx++) {
+			minesweeper_region_t& region = r.regions[by * r.columns + bx];
+			region.x0 = bx * c.width > c.halo ? bx * c.width - c.halo : 0;
+			region.y0 = by * c.height > c.halo ? by * c.height - c.halo : 0;
+			region.x1 = std::min(x_tiles, (bx + 1) * c.width + c.halo);
+			region.y1 = std::min(y_tiles, (by + 1) * c.height + c.halo);
+		}
+	}
+}
+
+// counts a new certainty for every window holding the tile
+inline void minesweeper_regions_touch(minesweeper_regions_t& r, uint32_t tile) {
+	const minesweeper_region_config_t& c = r.config;
+	uint32_t x = tile % r.x_tiles;
+	uint32_t y = tile / r.x_tiles;
+	uint32_t bx0 = x >= c.halo ? (x - c.halo) / c.width : 0;
+	uint32_t by0 = y >= c.halo ? (y - c.halo) / c.height : 0;
+	uint32_t bx1 = std::min(r.columns - 1, (x + c.halo) / c.width);
+	uint32_t by1 = std::min(r.rows - 1, (y + c.halo) / c.height);
+	for (uint32_t by = by0; by <= by1; by++) {
+		for (uint32_t bx = bx0; bx <= bx1; bx++)
+			r.regions[by * r.columns + bx].fresh++;
+	}
+}
+
+// solves one window on its own. numbers on a cut edge of the window are missing neighbors, so they are turned
+// into hidden tiles: that only drops constraints and adds unknowns which are really safe, and anything true for
+// every assignment of the weaker problem is true for the real board.
+inline void minesweeper_region_solve(minesweeper_region_t& region, minesweeper_region_scratch_t& s, const minesweeper_solver_t& global, const std::vector<mine>& tiles, uint32_t x_tiles, uint32_t y_tiles) {
+	uint32_t w = region.x1 - region.x0;
+	uint32_t h = region.y1 - region.y0;
+	minesweeper_solver_t& solver = s.solver;
+	s.tiles.resize(size_t{ w } * h);
+	solver.marks.resize(s.tiles.size());
+	solver.queued.assign(s.tiles.size(), 0);
+	solver.safe.clear();
+	solver.mines.clear();
+	solver.work.clear();
+
+	for (uint32_t ly = 0; ly < h; ly++) {
+		bool cut_y = (ly == 0 && region.y0 > 0) || (ly == h - 1 && region.y1 < y_tiles);
+		for (uint32_t lx = 0; lx < w; lx++) {
+			bool cut = cut_y || (lx == 0 && region.x0 > 0) || (lx == w - 1 && region.x1 < x_tiles);
+			uint32_t tile = (region.y0 + ly) * x_tiles + region.x0 + lx;
+			uint32_t local = ly * w + lx;
+			mine m = tiles[tile];
+			uint8_t mark = global.marks[tile];
+			if (cut && !is_hidden(m)) {
+				m.flags |= (uint16_t)mine_flag::hidden;
+				m.nearby = 0;
+				mark = (uint8_t)solver_mark::unknown;
+			}
+			s.tiles[local] = m;
+			solver.marks[local] = mark;
+			if (!is_hidden(m) && is_near_mine(m)) {
+				solver.queued[local] = 1;
+				solver.work.emplace_back(local);
+			}
+		}
+	}
+
+	minesweeper_solve_local(solver, s.tiles, w, h);
+
+	region.safe.clear();
+	region.mines.clear();
+	for (uint32_t local : solver.safe)
+		region.safe.emplace_back((region.y0 + local / w) * x_tiles + region.x0 + local % w);
+	for (uint32_t local : solver.mines)
+		region.mines.emplace_back((region.y0 + local / w) * x_tiles + region.x0 + local % w);
+}
+
+// same answer as minesweeper_solve, with the pattern and elimination passes spread over the pool
+inline size_t minesweeper_solve_regions(thread_pool_t& pool, minesweeper_regions_t& r, minesweeper_solver_t& solver, const std::vector<mine>& tiles, uint32_t x_tiles, uint32_t y_tiles, uint64_t mine_count) {
+	minesweeper_regions_init(r, x_tiles, y_tiles, pool.size() + 1);
+	minesweeper_solver_reset(solver, tiles);
+	r.pending.resize(r.regions.size());
+	for (uint32_t i = 0; i < r.regions.size(); i++)
+		r.pending[i] = i;
+	r.rounds = 0;
+	r.solves = 0;
+
+	while (r.pending.size()) {
+		r.rounds++;
+		r.solves += r.pending.size();
+
+		// windows overlap, so they only read the shared marks here and everything is merged afterwards
+		parallel_for(pool, 0, r.pending.size(), 1, [&](size_t i, size_t worker) {
+			minesweeper_region_solve(r.regions[r.pending[i]], r.scratch[worker], solver, tiles, x_tiles, y_tiles);
+		});
+
+		// a window only has to be solved again for certainties it couldn't find itself
+		for (minesweeper_region_t& region : r.regions) {
+			region.fresh = 0;
+			region.own = 0;
+		}
+		for (uint32_t idx : r.pending) {
+			minesweeper_region_t& region = r.regions[idx];
+			for (uint32_t tile : region.safe)
+				region.own += solver.marks[tile] == (uint8_t)solver_mark::unknown;
+			for (uint32_t tile : region.mines)
+				region.own += solver.marks[tile] == (uint8_t)solver_mark::unknown;
+		}
+		for (uint32_t idx : r.pending) {
+			const minesweeper_region_t& region = r.regions[idx];
+			for (size_t pass = 0; pass < 2; pass++) {
+				solver_mark mark = pass ? solver_mark::mine : solver_mark::safe;
+				for (uint32_t tile : pass ? region.mines : region.safe) {
+					if (solver.marks[tile] != (uint8_t)solver_mark::unknown)
+						continue;
+					minesweeper_solver_mark(solver, tiles, x_tiles, y_tiles, tile, mark);
+					minesweeper_regions_touch(r, tile);
+				}
+			}
+		}
+		r.pending.clear();
+		for (uint32_t i = 0; i < r.regions.size(); i++) {
+			if (r.regions[i].fresh > r.regions[i].own)
+				r.pending.emplace_back(i);
+		}
+	}
+
+	// marking queued every number next to a new certainty, the global pass starts from those
+	minesweeper_solve_resume(solver, tiles, x_tiles, y_tiles, mine_count);
+	return solver.safe.size() + solver.mines.size();
+}
@@ -0,0 +1,298 @@
+// minesweeper_render_benchmark.cpp : the game's imgui frame rendered offscreen with scripted mouse input, for
+// machines without a display. an egl pbuffer stands in for the glfw window, every board goes through hovering,
+// zooming, dragging and clicking, and each frame's draw list build, vertex and index counts, submit and gpu
+// time are written as csv.
+//
+
+// egl first, the loader only declares the khronos types khrplatform.h hasn't
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include "minesweeper_app.h"
+#include "minesweeper_simulate.h"
+#include "imgui/imgui_impl_opengl3_loader.h"
+#include <cstdio>
+
+// surfaceless mesa where it exists, so not even a gbm device or an x server is needed, else the default display
+static bool benchmark_egl_setup(int width, int height) {
+	EGLDisplay display = EGL_NO_DISPLAY;
+	auto get_platform_display = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+	if (get_platform_display)
+		display = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+	if (display == EGL_NO_DISPLAY)
+		display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+	EGLint major = 0;
+	EGLint minor = 0;
+	if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor))
+		return false;
+
+	const EGLint config_attribs[] = {
+		EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+		EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8,
+		EGL_NONE,
+	};
+	EGLConfig config;
+	EGLint configs = 0;
+	if (!eglChooseConfig(display, config_attribs, &config, 1, &configs) || !configs)
+		return false;
+	const EGLint surface_attribs[] = { EGL_WIDTH, width, EGL_HEIGHT, height, EGL_NONE };
+	EGLSurface surface = eglCreatePbufferSurface(display, config, surface_attribs);
+	if (surface == EGL_NO_SURFACE || !eglBindAPI(EGL_OPENGL_API))
+		return false;
+	// the same core profile the shaders of both renderers are written against
+	const EGLint context_attribs[] = {
+		EGL_CONTEXT_MAJOR_VERSION, 3,
+		EGL_CONTEXT_MINOR_VERSION, 3,
+		EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+		EGL_NONE,
+	};
+	EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, context_attribs);
+	return context != EGL_NO_CONTEXT && eglMakeCurrent(display, surface, surface, context);
+}
+
+struct benchmark_frame_t {
+	uint32_t frame = 0;
+	const char* renderer = "";
+	float tile_dim = 0.0f;
+	int vtx = 0;
+	int idx = 0;
+	int cmds = 0;
+	frame_sample_t sample;
+	float build = 0.0f; // new frame through ImGui::Render, everything that fills the draw lists
+};
+
+// where the board is on screen at the start of every frame, clicks go to the tile under this point
+static ImVec2 benchmark_tile_center(const minesweeper_app_t& app, ImVec2 pos) {
+	uint32_t tile = minesweeper_camera_tile(app.camera, pos, app.x_tiles, app.y_tiles);
+	if (tile >= app.tiles.size())
+		return pos;
+	return { app.camera.origin.x + ((float)(tile % app.x_tiles) + 0.5f) * app.camera.tile_dim, app.camera.origin.y + ((float)(tile / app.x_tiles) + 0.5f) * app.camera.tile_dim };
+}
+
+// the same input every run: a quarter of the frames sweep the mouse over the fitted board after a first click
+// in the middle, then the wheel zooms in, the middle button drags the board around, and the last quarter clicks
+// along a line, flagging mines and revealing everything else so a game never ends early
+static void benchmark_script(minesweeper_app_t& app, uint32_t frame, uint32_t frames, ImVec2 view_size) {
+	ImGuiIO& io = ImGui::GetIO();
+	uint32_t quarter = std::max<uint32_t>(frames / 4, 1);
+	uint32_t phase = frame / quarter;
+	float t = (float)(frame % quarter) / (float)quarter;
+	ImVec2 center = { view_size.x * 0.5f, view_size.y * 0.5f };
+	ImVec2 board_max = minesweeper_camera_board_max(app.camera, app.x_tiles, app.y_tiles);
+	ImVec2 board_min = app.camera.origin;
+
+	if (phase == 0) {
+		if (frame == 2) {
+			io.AddMousePosEvent(center.x, center.y);
+			io.AddMouseButtonEvent(ImGuiMouseButton_Left, true);
+		}
+		else if (frame == 3)
+			io.AddMouseButtonEvent(ImGuiMouseButton_Left, false);
+		else {
+			ImVec2 to = { std::min(board_max.x, view_size.x) - 1.0f, std::min(board_max.y, view_size.y) - 1.0f };
+			io.AddMousePosEvent(board_min.x + (to.x - board_min.x) * t, board_min.y + (to.y - board_min.y) * t);
+		}
+	}
+	else if (phase == 1) {
+		io.AddMousePosEvent(center.x, center.y);
+		if (frame % 3 == 0)
+			io.AddMouseWheelEvent(0.0f, 1.0f);
+	}
+	else if (phase == 2) {
+		// a circle around the center, held down the whole time
+		float angle = t * 6.2831853f;
+		float radius = std::min(view_size.x, view_size.y) * 0.25f;
+		io.AddMousePosEvent(center.x + radius * std::cos(angle), center.y + radius * std::sin(angle));
+		io.AddMouseButtonEvent(ImGuiMouseButton_Middle, frame % quarter != quarter - 1);
+	}
+	else {
+		ImVec2 pos = benchmark_tile_center(app, { view_size.x * (0.1f + 0.8f * t), view_size.y * (0.3f + 0.4f * t) });
+		io.AddMousePosEvent(pos.x, pos.y);
+		// press on one frame and let go on the next
+		uint32_t tile = minesweeper_camera_tile(app.camera, pos, app.x_tiles, app.y_tiles);
+		if (frame % 4 == 0 && tile < app.tiles.size() && is_hidden(app.tiles[tile]) && !is_flagged(app.tiles[tile]))
+			io.AddMouseButtonEvent(is_mine(app.tiles[tile]) ? ImGuiMouseButton_Right : ImGuiMouseButton_Left, true);
+		else if (frame % 4 == 1) {
+			io.AddMouseButtonEvent(ImGuiMouseButton_Left, false);
+			io.AddMouseButtonEvent(ImGuiMouseButton_Right, false);
+		}
+	}
+}
+
+static void benchmark_board(minesweeper_app_t& app, const simulate_difficulty_t& difficulty, uint32_t frames, ImVec2 view_size, std::vector<benchmark_frame_t>& out) {
+	minesweeper_app_new_board(app, difficulty.x_tiles, difficulty.y_tiles, (uint32_t)difficulty.mine_count, 0);
+	ImGuiIO& io = ImGui::GetIO();
+	io.AddMousePosEvent(-FLT_MAX, -FLT_MAX);
+	io.AddMouseButtonEvent(ImGuiMouseButton_Left, false);
+	io.AddMouseButtonEvent(ImGuiMouseButton_Right, false);
+	io.AddMouseButtonEvent(ImGuiMouseButton_Middle, false);
+
+	for (uint32_t frame = 0; frame < frames; frame++) {
+		benchmark_frame_t row;
+		row.frame = frame;
+		{
+			minesweeper_frame_timer_t timer(app.profile, frame_phase::poll);
+			benchmark_script(app, frame, frames, view_size);
+			// a steady 60hz, so held keys and drags move the same distance every run
+			io.DisplaySize = view_size;
+			io.DeltaTime = 1.0f / 60.0f;
+
+			timer.next(frame_phase::new_frame);
+			ImGui_ImplOpenGL3_NewFrame();
+			ImGui::NewFrame();
+			timer.next(frame_phase::update);
+			minesweeper_app_frame(app, timer, view_size);
+			timer.next(frame_phase::render);
+			ImGui::Render();
+
+			timer.next(frame_phase::render_draw_data);
+			glViewport(0, 0, (GLsizei)view_size.x, (GLsizei)view_size.y);
+			glClearColor(0.45f, 0.55f, 0.60f, 1.00f);
+			glClear(GL_COLOR_BUFFER_BIT);
+			ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+			// no swap without a window, waiting for the gpu to finish takes its place
+			timer.next(frame_phase::swap);
+			glFinish();
+		}
+
+		const ImDrawData* draw_data = ImGui::GetDrawData();
+		row.vtx = draw_data->TotalVtxCount;
+		row.idx = draw_data->TotalIdxCount;
+		for (int n = 0; n < draw_data->CmdListsCount; n++)
+			row.cmds += draw_data->CmdLists[n]->CmdBuffer.Size;
+		row.tile_dim = app.camera.tile_dim;
+		bool use_minimap = minesweeper_minimap_fits(app.minimap, app.x_tiles, app.y_tiles) && app.camera.tile_dim < minesweeper_minimap_max_tile;
+		row.renderer = use_minimap ? "minimap" : app.use_gl ? "gl" : "mesh";
+		uint64_t written = app.profile.written.load(std::memory_order_acquire);
+		row.sample = app.profile.frames[(written - 1) & (minesweeper_profile_t::capacity - 1)];
+		for (frame_phase phase : { frame_phase::new_frame, frame_phase::update, frame_phase::draw, frame_phase::scan, frame_phase::overlay, frame_phase::render })
+			row.build += row.sample.ms[(size_t)phase];
+		out.emplace_back(row);
+	}
+}
+
+static float benchmark_percentile(std::vector<float> values, float q) {
+	if (values.empty())
+		return 0.0f;
+	std::sort(values.begin(), values.end());
+	return values[std::min(values.size() - 1, (size_t)(q * (float)values.size()))];
+}
+
+static void benchmark_usage() {
+	std::fprintf(stderr,
+		"usage: minesweeper_render_benchmark [options]\n"
+		"  --difficulty D    easy, intermediate, expert, all or WxHxM, may repeat (all and boards up to 4000x4000)\n"
+		"  --frames N        scripted frames per board (240)\n"
+		"  --size WxH        framebuffer size (1920x1080)\n"
+		"  --no-ring         upload draw lists the old way instead of through the backend's buffer ring\n"
+		"  --out FILE        per frame csv output (minesweeper_render_benchmark.csv)\n");
+}
+
+int main(int argc, char** argv) {
+	uint32_t frames = 240;
+	int width = 1920;
+	int height = 1080;
+	bool ring = true;
+	const char* out = "minesweeper_render_benchmark.csv";
+	std::vector<simulate_difficulty_t> difficulties;
+
+	for (int i = 1; i < argc; i++) {
+		const char* arg = argv[i];
+		const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+		bool ok = value != nullptr;
+		if (!std::strcmp(arg, "--no-ring")) {
+			ring = false;
+			continue;
+		}
+		if (!std::strcmp(arg, "--frames") && ok)
+			frames = (uint32_t)std::strtoul(value, nullptr, 10);
+		else if (!std::strcmp(arg, "--size") && ok)
+			ok = std::sscanf(value, "%dx%d", &width, &height) == 2 && width > 0 && height > 0;
+		else if (!std::strcmp(arg, "--out") && ok)
+			out = value;
+		else if (!std::strcmp(arg, "--difficulty") && ok)
+			ok = simulate_parse_difficulty(value, difficulties);
+		else
+			ok = false;
+
+		if (!ok || !frames) {
+			benchmark_usage();
+			return 1;
+		}
+		i++;
+	}
+	if (difficulties.empty()) {
+		difficulties.assign(simulate_difficulties.begin(), simulate_difficulties.end());
+		// past the mesh, past the shader's tile count and into the minimap when zoomed out
+		difficulties.emplace_back(simulate_difficulty_t{ "custom", 100, 100, 1600 });
+		difficulties.emplace_back(simulate_difficulty_t{ "custom", 500, 500, 40000 });
+		difficulties.emplace_back(simulate_difficulty_t{ "custom", 2000, 2000, 640000 });
+		difficulties.emplace_back(simulate_difficulty_t{ "custom", 4000, 4000, 2560000 });
+	}
+
+	if (!benchmark_egl_setup(width, height)) {
+		std::fprintf(stderr, "no egl context\n");
+		return 1;
+	}
+	ImGui::CreateContext();
+	ImGui::GetIO().IniFilename = nullptr;
+	ImGui::StyleColorsDark();
+	const char* glsl_version = "#version 330 core";
+	if (!ImGui_ImplOpenGL3_Init(glsl_version)) {
+		std::fprintf(stderr, "no opengl 3 backend\n");
+		return 1;
+	}
+	std::printf("%s\n", (const char*)glGetString(GL_RENDERER));
+
+	FILE* file = std::fopen(out, "w");
+	if (!file) {
+		std::fprintf(stderr, "could not write %s\n", out);
+		return 1;
+	}
+	std::fprintf(file, "difficulty,x_tiles,y_tiles,mines,frame,renderer,tile_dim,vtx,idx,cmds,build_ms");
+	for (const char* name : frame_phase_names)
+		std::fprintf(file, ",%s", name);
+	std::fprintf(file, "\n");
+
+	minesweeper_app_t app;
+	minesweeper_app_init(app, glsl_version);
+	if (!ring)
+		app.buffer_ring = ImGui_ImplOpenGL3_SetBufferRing(false);
+	ImVec2 view_size = { (float)width, (float)height };
+
+	// render draw data is the cpu side of the submit, swap is the gpu catching up with it
+	std::printf("%-24s %10s %10s %10s %10s %10s %10s %10s %12s %12s\n", "difficulty", "build p50", "build p99", "submit p50", "submit p99", "gpu p50", "gpu p99",
+		"cmds max", "vtx max", "idx max");
+	for (const simulate_difficulty_t& difficulty : difficulties) {
+		std::vector<benchmark_frame_t> rows;
+		benchmark_board(app, difficulty, frames, view_size, rows);
+
+		std::vector<float> build, submit, gpu;
+		int cmds = 0, vtx = 0, idx = 0;
+		for (const benchmark_frame_t& row : rows) {
+			build.emplace_back(row.build);
+			submit.emplace_back(row.sample.ms[(size_t)frame_phase::render_draw_data]);
+			gpu.emplace_back(row.sample.ms[(size_t)frame_phase::swap]);
+			cmds = std::max(cmds, row.cmds);
+			vtx = std::max(vtx, row.vtx);
+			idx = std::max(idx, row.idx);
+			std::fprintf(file, "%s,%u,%u,%llu,%u,%s,%.3f,%d,%d,%d,%.4f", difficulty.name, difficulty.x_tiles, difficulty.y_tiles, (unsigned long long)difficulty.mine_count,
+				row.frame, row.renderer, row.tile_dim, row.vtx, row.idx, row.cmds, row.build);
+			for (float ms : row.sample.ms)
+				std::fprintf(file, ",%.4f", ms);
+			std::fprintf(file, "\n");
+		}
+
+		char name[64];
+		std::snprintf(name, sizeof(name), "%s %ux%u/%llu", difficulty.name, difficulty.x_tiles, difficulty.y_tiles, (unsigned long long)difficulty.mine_count);
+		std::printf("%-24s %10.3f %10.3f %10.3f %10.3f %10.3f %10.3f %10d %12d %12d\n", name, benchmark_percentile(build, 0.5f), benchmark_percentile(build, 0.99f),
+			benchmark_percentile(submit, 0.5f), benchmark_percentile(submit, 0.99f), benchmark_percentile(gpu, 0.5f), benchmark_percentile(gpu, 0.99f), cmds, vtx, idx);
+		std::fflush(stdout);
+	}
+	std::fclose(file);
+
+	minesweeper_app_shutdown(app);
+	ImGui_ImplOpenGL3_Shutdown();
+	ImGui::DestroyContext();
+	return 0;
+}
@@ -0,0 +1,113 @@
+﻿// minesweeper_simulate.cpp : headless autoplay, plays batches of complete games with a fixed policy and
+// reports how often it wins. no window, games are spread over the work stealing pool.
+//
+
+#include "minesweeper_simulate.h"
+#include <cstdio>
+
+static void simulate_usage() {
+	std::fprintf(stderr,
+		"usage: minesweeper_simulate [options]\n"
+		"  --games N         games per difficulty (1000)\n"
+		"  --policy P        solver, first-safe or random (solver)\n"
+		"  --difficulty D    easy, intermediate, expert, all or WxHxM (all), may repeat\n"
+		"  --threads N       pool threads (hardware concurrency)\n"
+		"  --seed N          base seed, the same seed plays the same games (0)\n"
+		"  --depth N         solver look ahead depth, 1 is lowest risk only (1)\n"
+		"  --samples N       solver boards sampled per candidate (32)\n"
+		"  --table-bits N    share a transposition table of 2^N positions between games, off when 0 (0)\n");
+}
+
+int main(int argc, char** argv) {
+	simulate_options_t options;
+	options.guess.parallel = false; // games are the unit of parallel work
+	options.guess.budget = std::chrono::hours(1); // results depend only on the seed, not on machine load
+	options.guess.depth = 1; // deeper look ahead costs seconds per expert game, opt in with --depth
+	const simulate_policy_t* policy = &simulate_policies[0];
+	uint32_t table_bits = 0;
+	std::vector<simulate_difficulty_t> difficulties;
+
+	for (int i = 1; i < argc; i++) {
+		const char* arg = argv[i];
+		const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+		bool ok = value != nullptr;
+		if (!std::strcmp(arg, "--games") && ok)
+			options.games = std::strtoull(value, nullptr, 10);
+		else if (!std::strcmp(arg, "--threads") && ok)
+			options.threads = std::strtoull(value, nullptr, 10);
+		else if (!std::strcmp(arg, "--seed") && ok)
+			options.seed = std::strtoull(value, nullptr, 10);
+		else if (!std::strcmp(arg, "--depth") && ok)
+			options.guess.depth = std::strtoul(value, nullptr, 10);
+		else if (!std::strcmp(arg, "--samples") && ok)
+			options.guess.samples = std::strtoul(value, nullptr, 10);
+		else if (!std::strcmp(arg, "--table-bits") && ok) {
+			// 16 bytes a slot, 28 bits is already 4 GB
+			table_bits = std::strtoul(value, nullptr, 10);
+			ok = table_bits <= 28;
+		}
+		else if (!std::strcmp(arg, "--difficulty") && ok)
+			ok = simulate_parse_difficulty(value, difficulties);
+		else if (!std::strcmp(arg, "--policy") && ok) {
+			policy = nullptr;
+			for (const simulate_policy_t& p : simulate_policies)
+				policy = !std::strcmp(value, p.name) ? &p : policy;
+			ok = policy != nullptr;
+		}
+		else
+			ok = false;
+
+		if (!ok) {
+			simulate_usage();
+			return 1;
+		}
+		i++;
+	}
+	if (difficulties.empty())
+		difficulties.assign(simulate_difficulties.begin(), simulate_difficulties.end());
+
+	std::unique_ptr<minesweeper_transposition_t> table;
+	if (table_bits) {
+		table = std::make_unique<minesweeper_transposition_t>(table_bits);
+		options.table = table.get();
+	}
+
+	// the calling thread helps in wait(), so it counts as one of the threads
+	thread_pool_t pool(std::max<size_t>(options.threads, 2) - 1);
+	std::printf("policy %s, %llu games per difficulty, %zu threads\n\n", policy->name, (unsigned long long)options.games, pool.size() + 1);
+	std::printf("%-22s %8s %9s %8s %8s %8s %10s %12s %12s %9s\n", "difficulty", "games", "win rate", "3bv", "clicks", "guesses", "games/s", "tt probes", "tt hits", "hit rate");
+
+	for (const simulate_difficulty_t& difficulty : difficulties) {
+		std::vector<simulate_stats_t> stats(pool.size() + 1);
+		minesweeper_transposition_stats_t table_start = table ? minesweeper_transposition_stats(*table) : minesweeper_transposition_stats_t{};
+		auto start = std::chrono::steady_clock::now();
+		parallel_for(pool, 0, options.games, 1, [&](size_t game, size_t worker) {
+			simulate_result_t r = simulate_game(difficulty, policy->fn, options, pool, game);
+			simulate_stats_t& s = stats[worker];
+			s.games++;
+			s.wins += r.won;
+			s.clicks_required += r.clicks_required;
+			s.clicks += r.clicks;
+			s.guesses += r.guesses;
+		});
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		simulate_stats_t total;
+		for (const simulate_stats_t& s : stats) {
+			total.games += s.games;
+			total.wins += s.wins;
+			total.clicks_required += s.clicks_required;
+			total.clicks += s.clicks;
+			total.guesses += s.guesses;
+		}
+		double games = total.games ? double(total.games) : 1.0;
+		minesweeper_transposition_stats_t t = table ? minesweeper_transposition_delta(minesweeper_transposition_stats(*table), table_start) : minesweeper_transposition_stats_t{};
+		char name[64];
+		std::snprintf(name, sizeof(name), "%s %ux%u/%llu", difficulty.name, difficulty.x_tiles, difficulty.y_tiles, (unsigned long long)difficulty.mine_count);
+		std::printf("%-22s %8llu %8.2f%% %8.2f %8.2f %8.3f %10.1f %12llu %12llu %8.2f%%\n", name, (unsigned long long)total.games,
+			100.0 * total.wins / games, total.clicks_required / games, total.clicks / games, total.guesses / games, total.games / seconds,
+			(unsigned long long)t.probes, (unsigned long long)t.hits, 100.0 * t.hit_rate);
+		std::fflush(stdout);
+	}
+	return 0;
+}
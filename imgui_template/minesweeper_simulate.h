@@ -0,0 +1,231 @@
+﻿// minesweeper_simulate.h : autoplay of complete games with pluggable policies, shared by the simulator and
+// the benchmark. policies only ever see the visible board.
+
+#pragma once
+
+#include "minesweeper.h"
+#include "minesweeper_guess.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <array>
+#include <chrono>
+
+struct simulate_difficulty_t {
+	const char* name;
+	uint32_t x_tiles;
+	uint32_t y_tiles;
+	uint64_t mine_count;
+};
+
+// same boards as the buttons in the game
+constexpr std::array<simulate_difficulty_t, 3> simulate_difficulties = {
+	simulate_difficulty_t{ "easy", 9, 9, 10 },
+	simulate_difficulty_t{ "intermediate", 16, 16, 40 },
+	simulate_difficulty_t{ "expert", 30, 16, 99 },
+};
+
+struct simulate_options_t {
+	uint64_t games = 1000;
+	uint64_t seed = 0;
+	size_t threads = std::thread::hardware_concurrency();
+	minesweeper_guess_config_t guess;
+	// positions the solver policy has already valued, shared by every game. with games running in parallel the
+	// values found depend on which games got there first, so results are only reproducible without one
+	minesweeper_transposition_t* table = nullptr;
+	bool clicks_required = true; // 3bv of every board after its first click, seconds a game on huge boards
+	std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max(); // games still running are abandoned
+};
+
+// everything a policy may look at or keep between clicks. visible never holds mines or hidden numbers.
+struct simulate_game_t {
+	uint32_t x_tiles = 0;
+	uint32_t y_tiles = 0;
+	uint64_t mine_count = 0;
+	std::vector<mine> visible;
+	minesweeper_solver_t solver;
+	std::vector<uint32_t> safe; // proven safe tiles not clicked yet
+	chacha8r rng = chacha8r(0, 0);
+	uint64_t seed = 0;
+	uint32_t max_frontier = 0; // most undecided tiles next to numbers after any solve
+	const simulate_options_t* options = nullptr;
+	thread_pool_t* pool = nullptr;
+};
+
+struct simulate_move_t {
+	uint32_t tile = ~uint32_t{ 0 };
+	bool guess = false; // the policy couldn't prove the tile safe
+};
+
+using simulate_policy_fn = simulate_move_t(*)(simulate_game_t& game);
+
+inline uint32_t simulate_random_hidden(simulate_game_t& game, bool undecided_only) {
+	std::vector<uint32_t>& picks = game.safe;
+	picks.clear();
+	for (size_t i = 0; i < game.visible.size(); i++) {
+		bool undecided = !undecided_only || game.solver.marks[i] == (uint8_t)solver_mark::unknown;
+		if (is_hidden(game.visible[i]) && !is_flagged(game.visible[i]) && undecided)
+			picks.emplace_back(i);
+	}
+	uint32_t tile = picks.size() ? picks[solver_random(game.rng, picks.size())] : ~uint32_t{ 0 };
+	picks.clear();
+	return tile;
+}
+
+// clicks one of the proven safe tiles left over from the last solve, solving again once they run out
+inline bool simulate_next_safe(simulate_game_t& game, uint32_t& tile) {
+	for (size_t pass = 0; pass < 2; pass++) {
+		while (game.safe.size()) {
+			tile = game.safe.back();
+			game.safe.pop_back();
+			if (is_hidden(game.visible[tile]))
+				return true;
+		}
+		if (pass)
+			break;
+		minesweeper_solve(game.solver, game.visible, game.x_tiles, game.y_tiles, game.mine_count);
+		game.max_frontier = std::max<uint32_t>(game.max_frontier, game.solver.frontier.size());
+		game.safe.assign(game.solver.safe.begin(), game.solver.safe.end());
+	}
+	return false;
+}
+
+// uniformly random hidden tile, the baseline everything else should beat
+inline simulate_move_t simulate_policy_random(simulate_game_t& game) {
+	return { simulate_random_hidden(game, false), true };
+}
+
+// logic only: proven safe tiles first, a random undecided tile when stuck
+inline simulate_move_t simulate_policy_first_safe(simulate_game_t& game) {
+	uint32_t tile;
+	if (simulate_next_safe(game, tile))
+		return { tile, false };
+	return { simulate_random_hidden(game, true), true };
+}
+
+// logic, then probabilities with look ahead when stuck
+inline simulate_move_t simulate_policy_solver(simulate_game_t& game) {
+	uint32_t tile;
+	if (simulate_next_safe(game, tile))
+		return { tile, false };
+	minesweeper_guess_t guess = minesweeper_guess(*game.pool, game.visible, game.x_tiles, game.y_tiles, game.mine_count, game.options->guess, game.seed++, game.options->table);
+	return { guess.tile, guess.mine_probability > 0.0f };
+}
+
+struct simulate_policy_t {
+	const char* name;
+	simulate_policy_fn fn;
+};
+
+constexpr std::array<simulate_policy_t, 3> simulate_policies = {
+	simulate_policy_t{ "solver", simulate_policy_solver },
+	simulate_policy_t{ "first-safe", simulate_policy_first_safe },
+	simulate_policy_t{ "random", simulate_policy_random },
+};
+
+// one per pool worker, padded so workers finishing games never share a cache line
+struct alignas(64) simulate_stats_t {
+	uint64_t games = 0;
+	uint64_t wins = 0;
+	uint64_t clicks_required = 0; // 3bv
+	uint64_t clicks = 0;
+	uint64_t guesses = 0;
+};
+
+struct simulate_result_t {
+	uint64_t finished = 0; // 0 when the deadline cut the game short
+	uint64_t won = 0;
+	uint64_t clicks_required = 0;
+	uint64_t clicks = 0;
+	uint64_t guesses = 0;
+	uint32_t max_frontier = 0;
+};
+
+// board (optional) receives the board as played, after the first click moved a mine out of the way. stream picks
+// the policy's random choices, replaying a board with another stream plays it again with different guesses.
+inline simulate_result_t simulate_game(const simulate_difficulty_t& difficulty, simulate_policy_fn policy, const simulate_options_t& options, thread_pool_t& pool, uint64_t index, std::vector<mine>* board = nullptr, uint64_t stream = 0) {
+	simulate_result_t result;
+	simulate_game_t game;
+	game.x_tiles = difficulty.x_tiles;
+	game.y_tiles = difficulty.y_tiles;
+	game.mine_count = difficulty.mine_count;
+	uint64_t salt = stream ? zobrist_mix(stream) : 0;
+	game.rng = chacha8r(options.seed ^ salt, index);
+	game.seed = zobrist_mix(options.seed ^ zobrist_mix(index)) ^ salt;
+	game.options = &options;
+	game.pool = &pool;
+
+	// games are reproducible from (seed, index) no matter which worker plays them
+	minesweeper_seed_t seed = minesweeper_seed(options.seed + index);
+	std::vector<mine> tiles;
+	std::vector<mine> copy;
+	std::vector<uint32_t> idxs;
+	minesweeper_start(tiles, game.x_tiles, game.y_tiles, game.mine_count, seed);
+	minesweeper_neighbors_2d(tiles, game.x_tiles, game.y_tiles);
+	game.visible.resize(tiles.size());
+
+	bool first_click = true;
+	for (;;) {
+		size_t hidden = 0;
+		for (size_t i = 0; i < tiles.size(); i++) {
+			hidden += is_hidden(tiles[i]);
+			game.visible[i].flags = tiles[i].flags & ~(uint16_t)mine_flag::mine;
+			game.visible[i].nearby = is_hidden(tiles[i]) ? 0 : tiles[i].nearby;
+		}
+		if (hidden == game.mine_count) {
+			result.finished = 1;
+			result.won = 1;
+			break;
+		}
+		if (std::chrono::steady_clock::now() > options.deadline)
+			break;
+
+		simulate_move_t move = policy(game);
+		if (move.tile >= tiles.size()) {
+			result.finished = 1;
+			break;
+		}
+		if (first_click) {
+			// the first click is never a mine, same as the game
+			first_click = false;
+			move.guess = false;
+			minesweeper_swap_to_empty_tile(tiles, idxs, move.tile, seed);
+			minesweeper_neighbors_2d(tiles, game.x_tiles, game.y_tiles);
+			if (options.clicks_required)
+				result.clicks_required = minesweeper_minimum_clicks(copy, tiles, idxs, game.x_tiles, game.y_tiles);
+			if (board)
+				board->assign(tiles.begin(), tiles.end());
+		}
+
+		result.clicks++;
+		result.guesses += move.guess;
+		if (is_mine(tiles[move.tile])) {
+			result.finished = 1;
+			break;
+		}
+		minesweeper_reveal(tiles, idxs, game.x_tiles, game.y_tiles, move.tile);
+	}
+	result.max_frontier = game.max_frontier;
+	return result;
+}
+
+inline bool simulate_parse_difficulty(const char* text, std::vector<simulate_difficulty_t>& out) {
+	if (!std::strcmp(text, "all")) {
+		out.assign(simulate_difficulties.begin(), simulate_difficulties.end());
+		return true;
+	}
+	for (const simulate_difficulty_t& d : simulate_difficulties) {
+		if (!std::strcmp(text, d.name)) {
+			out.emplace_back(d);
+			return true;
+		}
+	}
+	// custom WxHxM
+	uint32_t x = 0, y = 0;
+	unsigned long long m = 0;
+	if (std::sscanf(text, "%ux%ux%llu", &x, &y, &m) == 3 && x && y && m < uint64_t{ x } * y) {
+		out.emplace_back(simulate_difficulty_t{ "custom", x, y, m });
+		return true;
+	}
+	return false;
+}
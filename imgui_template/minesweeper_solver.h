@@ -0,0 +1,1015 @@
+﻿// minesweeper_solver.h : deduces safe tiles and mines using only what the
+// player can see (hidden / revealed tiles and their numbers).
+
+#pragma once
+
+#include "minesweeper.h"
+#include <bit>
+#include <cmath>
+#include <string>
+#include <unordered_map>
+
+enum class solver_mark : uint8_t {
+	unknown = 0,
+	safe = 1,
+	mine = 2,
+};
+
+struct solver_offset {
+	int x = {};
+	int y = {};
+};
+
+// same ordering as minesweeper_neighbors_2d, bit o of a neighborhood mask is solver_offsets[o]
+constexpr std::array<solver_offset, 8> solver_offsets = {
+	solver_offset{-1, -1}, solver_offset{0, -1}, solver_offset{1, -1},
+	solver_offset{-1,  0},                       solver_offset{1,  0},
+	solver_offset{-1,  1}, solver_offset{0,  1}, solver_offset{1,  1}
+};
+
+// single tile patterns, indexed by (hidden unknown neighbor mask << 4) | mines left to place
+// low byte: neighbors forced safe, high byte: neighbors forced to be mines
+constexpr std::array<uint16_t, 256 * 16> solver_single_table = [] {
+	std::array<uint16_t, 256 * 16> table = {};
+	for (uint32_t mask = 0; mask < 256; mask++) {
+		uint32_t unknown = std::popcount(mask);
+		for (uint32_t left = 0; left < 16; left++) {
+			uint16_t result = 0;
+			if (left == 0)
+				result = mask;
+			else if (left == unknown)
+				result = mask << 8;
+			table[(mask << 4) | left] = result;
+		}
+	}
+	return table;
+}();
+
+// pair patterns (1-1, 1-2, 1-2-1 and corner cases) for two numbers within a 5x5 window of each other.
+// the unknown tiles around them split into three groups: only next to a, shared, only next to b.
+// each group is forced safe (1), forced mines (2) or undecided (0), 2 bits per group in a, shared, b order.
+constexpr uint32_t solver_pair_index(uint32_t a_only, uint32_t shared, uint32_t b_only, uint32_t a_left, uint32_t b_left) {
+	return (((a_only * 5 + shared) * 9 + b_only) * 9 + a_left) * 9 + b_left;
+}
+
+constexpr std::array<uint8_t, 9 * 5 * 9 * 9 * 9> solver_pair_table = [] {
+	std::array<uint8_t, 9 * 5 * 9 * 9 * 9> table = {};
+	for (uint32_t a = 0; a < 9; a++) {
+		for (uint32_t s = 0; s < 5; s++) {
+			for (uint32_t b = 0; b < 9; b++) {
+				for (uint32_t a_left = 0; a_left < 9; a_left++) {
+					for (uint32_t b_left = 0; b_left < 9; b_left++) {
+						// mines in the shared group range over every split that fits both numbers
+						int ks_lo = std::max({ 0, (int)a_left - (int)a, (int)b_left - (int)b });
+						int ks_hi = std::min({ (int)s, (int)a_left, (int)b_left });
+
+						uint8_t result = 0;
+						if (ks_lo <= ks_hi) {
+							// min / max mines per group (a only, shared, b only)
+							uint32_t lo[3] = { a_left - ks_hi, (uint32_t)ks_lo, b_left - ks_hi };
+							uint32_t hi[3] = { a_left - ks_lo, (uint32_t)ks_hi, b_left - ks_lo };
+							uint32_t size[3] = { a, s, b };
+							for (uint32_t g = 0; g < 3; g++) {
+								if (size[g] == 0)
+									continue;
+								if (hi[g] == 0)
+									result |= (uint8_t)solver_mark::safe << (g * 2);
+								else if (lo[g] == size[g])
+									result |= (uint8_t)solver_mark::mine << (g * 2);
+							}
+						}
+						table[solver_pair_index(a, s, b, a_left, b_left)] = result;
+					}
+				}
+			}
+		}
+	}
+	return table;
+}();
+
+struct minesweeper_solver_t {
+	std::vector<uint8_t> marks; // solver_mark per tile
+	std::vector<uint32_t> safe; // hidden tiles proven safe
+	std::vector<uint32_t> mines; // hidden tiles proven to be mines
+	std::vector<uint32_t> work; // numbered tiles waiting to be (re)checked
+	std::vector<uint8_t> queued;
+
+	// frontier: unknown hidden tiles next to a number, grouped into independent components
+	std::vector<uint32_t> column; // per tile, index into frontier or ~0
+	std::vector<uint32_t> frontier; // tiles, sorted by component
+	std::vector<uint32_t> frontier_start; // component c owns frontier[frontier_start[c]] to frontier[frontier_start[c + 1]]
+	std::vector<uint32_t> constraints; // numbered tiles, sorted by component
+	std::vector<uint32_t> constraint_start;
+	std::vector<uint32_t> parent; // union find / sorting scratch
+	std::vector<uint32_t> scratch;
+
+	// linear stage rows, coefficients in {-1, 0, 1} stored as two bitsets per row
+	std::vector<uint64_t> row_pos;
+	std::vector<uint64_t> row_neg;
+	std::vector<int32_t> row_rhs;
+
+	std::vector<float> probability; // per tile chance of being a mine, filled by the probability stages
+};
+
+// numbered, revealed tile which still touches a hidden tile the solver knows nothing about
+inline bool minesweeper_solver_is_constraint(const minesweeper_solver_t& solver, const std::vector<mine>& tiles, uint32_t x_tiles, uint32_t y_tiles, uint32_t tile) {
+	if (is_hidden(tiles[tile]) || !is_near_mine(tiles[tile]))
+		return false;
+	int x = tile % x_tiles;
+	int y = tile / x_tiles;
+	for (size_t o = 0; o < solver_offsets.size(); o++) {
+		int nx = x + solver_offsets[o].x;
+		int ny = y + solver_offsets[o].y;
+		if (nx < 0 || ny < 0 || nx >= (int)x_tiles || ny >= (int)y_tiles)
+			continue;
+		if (solver.marks[ny * x_tiles + nx] == (uint8_t)solver_mark::unknown)
+			return true;
+	}
+	return false;
+}
+
+inline void minesweeper_solver_queue_around(minesweeper_solver_t& solver, const std::vector<mine>& tiles, uint32_t x_tiles, uint32_t y_tiles, uint32_t tile) {
+	int x = tile % x_tiles;
+	int y = tile / x_tiles;
+	for (size_t o = 0; o < solver_offsets.size(); o++) {
+		int nx = x + solver_offsets[o].x;
+		int ny = y + solver_offsets[o].y;
+		if (nx < 0 || ny < 0 || nx >= (int)x_tiles || ny >= (int)y_tiles)
+			continue;
+		uint32_t idx = ny * x_tiles + nx;
+		if (!solver.queued[idx] && !is_hidden(tiles[idx]) && is_near_mine(tiles[idx])) {
+			solver.queued[idx] = 1;
+			solver.work.emplace_back(idx);
+		}
+	}
+}
+
+// returns false if the tile was already decided the other way (the visible state is inconsistent)
+inline bool minesweeper_solver_mark(minesweeper_solver_t& solver, const std::vector<mine>& tiles, uint32_t x_tiles, uint32_t y_tiles, uint32_t tile, solver_mark mark) {
+	uint8_t& current = solver.marks[tile];
+	if (current != (uint8_t)solver_mark::unknown)
+		return current == (uint8_t)mark;
+
+	current = (uint8_t)mark;
+	if (mark == solver_mark::safe)
+		solver.safe.emplace_back(tile);
+	else
+		solver.mines.emplace_back(tile);
+	minesweeper_solver_queue_around(solver, tiles, x_tiles, y_tiles, tile);
+	return true;
+}
+
+inline void minesweeper_solver_reset(minesweeper_solver_t& solver, const std::vector<mine>& tiles) {
+	solver.marks.resize(tiles.size());
+	solver.queued.assign(tiles.size(), 0);
+	solver.safe.clear();
+	solver.mines.clear();
+	solver.work.clear();
+
+	for (size_t i = 0; i < tiles.size(); i++) {
+		solver.marks[i] = is_hidden(tiles[i]) ? (uint8_t)solver_mark::unknown : (uint8_t)solver_mark::safe;
+		if (!is_hidden(tiles[i]) && is_near_mine(tiles[i])) {
+			solver.queued[i] = 1;
+			solver.work.emplace_back(i);
+		}
+	}
+}
+
+struct solver_neighborhood_t {
+	uint32_t unknown_mask = 0;
+	uint32_t mines_left = 0;
+	std::array<uint32_t, 8> tile = {};
+};
+
+inline solver_neighborhood_t minesweeper_solver_neighborhood(const minesweeper_solver_t& solver, const std::vector<mine>& tiles, uint32_t x_tiles, uint32_t y_tiles, uint32_t tile) {
+	solver_neighborhood_t n = {};
+	int x = tile % x_tiles;
+	int y = tile / x_tiles;
+	uint32_t known_mines = 0;
+	for (size_t o = 0; o < solver_offsets.size(); o++) {
+		int nx = x + solver_offsets[o].x;
+		int ny = y + solver_offsets[o].y;
+		if (nx < 0 || ny < 0 || nx >= (int)x_tiles || ny >= (int)y_tiles)
+			continue;
+		uint32_t idx = ny * x_tiles + nx;
+		n.tile[o] = idx;
+		uint8_t mark = solver.marks[idx];
+		n.unknown_mask |= (mark == (uint8_t)solver_mark::unknown) << o;
+		known_mines += mark == (uint8_t)solver_mark::mine;
+	}
+	// more mines decided than the number allows means the board is inconsistent, clamp so the lookup finds nothing
+	n.mines_left = tiles[tile].nearby >= known_mines ? std::min<uint32_t>(tiles[tile].nearby - known_mines, 15) : 15;
+	return n;
+}
+
+inline size_t minesweeper_solve_single(minesweeper_solver_t& solver, const std::vector<mine>& tiles, uint32_t x_tiles, uint32_t y_tiles) {
+	size_t found = solver.safe.size() + solver.mines.size();
+	while (solver.work.size()) {
+		uint32_t tile = solver.work.back();
+		solver.work.pop_back();
+		solver.queued[tile] = 0;
+
+		solver_neighborhood_t n = minesweeper_solver_neighborhood(solver, tiles, x_tiles, y_tiles, tile);
+		if (!n.unknown_mask)
+			continue;
+
+		uint16_t result = solver_single_table[(n.unknown_mask << 4) | n.mines_left];
+		for (uint32_t bits = result & 0xff; bits; bits &= bits - 1)
+			minesweeper_solver_mark(solver, tiles, x_tiles, y_tiles, n.tile[std::countr_zero(bits)], solver_mark::safe);
+		for (uint32_t bits = result >> 8; bits; bits &= bits - 1)
+			minesweeper_solver_mark(solver, tiles, x_tiles, y_tiles, n.tile[std::countr_zero(bits)], solver_mark::mine);
+	}
+	return (solver.safe.size() + solver.mines.size()) - found;
+}
+
+inline size_t minesweeper_solve_pairs(minesweeper_solver_t& solver, const std::vector<mine>& tiles, uint32_t x_tiles, uint32_t y_tiles) {
+	size_t found = solver.safe.size() + solver.mines.size();
+	for (size_t a = 0; a < tiles.size(); a++) {
+		if (!minesweeper_solver_is_constraint(solver, tiles, x_tiles, y_tiles, a))
+			continue;
+
+		int ax = a % x_tiles;
+		int ay = a / x_tiles;
+		// only look forward (b > a) in the 5x5 window, the pattern table is symmetric in a and b
+		for (int dy = 0; dy <= 2; dy++) {
+			for (int dx = -2; dx <= 2; dx++) {
+				if (dy == 0 && dx <= 0)
+					continue;
+				int bx = ax + dx;
+				int by = ay + dy;
+				if (bx < 0 || by < 0 || bx >= (int)x_tiles || by >= (int)y_tiles)
+					continue;
+				uint32_t b = by * x_tiles + bx;
+				if (!minesweeper_solver_is_constraint(solver, tiles, x_tiles, y_tiles, b))
+					continue;
+
+				solver_neighborhood_t na = minesweeper_solver_neighborhood(solver, tiles, x_tiles, y_tiles, a);
+				solver_neighborhood_t nb = minesweeper_solver_neighborhood(solver, tiles, x_tiles, y_tiles, b);
+
+				// unknown tiles of a which are also next to b
+				uint32_t a_shared = 0;
+				for (uint32_t bits = na.unknown_mask; bits; bits &= bits - 1) {
+					solver_offset o = solver_offsets[std::countr_zero(bits)];
+					int sx = o.x - dx;
+					int sy = o.y - dy;
+					a_shared |= (sx >= -1 && sx <= 1 && sy >= -1 && sy <= 1) << std::countr_zero(bits);
+				}
+				uint32_t b_shared = 0;
+				for (uint32_t bits = nb.unknown_mask; bits; bits &= bits - 1) {
+					solver_offset o = solver_offsets[std::countr_zero(bits)];
+					int sx = o.x + dx;
+					int sy = o.y + dy;
+					b_shared |= (sx >= -1 && sx <= 1 && sy >= -1 && sy <= 1) << std::countr_zero(bits);
+				}
+
+				uint32_t shared = std::popcount(a_shared);
+				if (!shared || na.mines_left > 8 || nb.mines_left > 8)
+					continue;
+
+				uint32_t a_only = na.unknown_mask & ~a_shared;
+				uint32_t b_only = nb.unknown_mask & ~b_shared;
+				uint8_t result = solver_pair_table[solver_pair_index(std::popcount(a_only), shared, std::popcount(b_only), na.mines_left, nb.mines_left)];
+				if (!result)
+					continue;
+
+				std::array<uint32_t, 3> groups = { a_only, a_shared, 0 };
+				for (size_t g = 0; g < 3; g++) {
+					uint8_t mark = (result >> (g * 2)) & 0x3;
+					if (!mark)
+						continue;
+					const solver_neighborhood_t& n = g == 2 ? nb : na;
+					uint32_t group = g == 2 ? b_only : groups[g];
+					for (uint32_t bits = group; bits; bits &= bits - 1)
+						minesweeper_solver_mark(solver, tiles, x_tiles, y_tiles, n.tile[std::countr_zero(bits)], (solver_mark)mark);
+				}
+			}
+		}
+	}
+	return (solver.safe.size() + solver.mines.size()) - found;
+}
+
+inline uint32_t minesweeper_solver_find(std::vector<uint32_t>& parent, uint32_t i) {
+	while (parent[i] != i) {
+		parent[i] = parent[parent[i]];
+		i = parent[i];
+	}
+	return i;
+}
+
+// collects the frontier and the numbers constraining it, split into components which share no tiles
+inline size_t minesweeper_solver_frontier(minesweeper_solver_t& solver, const std::vector<mine>& tiles, uint32_t x_tiles, uint32_t y_tiles) {
+	solver.column.assign(tiles.size(), ~uint32_t{ 0 });
+	solver.frontier.clear();
+	solver.constraints.clear();
+	solver.parent.clear();
+
+	for (size_t i = 0; i < tiles.size(); i++) {
+		if (!minesweeper_solver_is_constraint(solver, tiles, x_tiles, y_tiles, i))
+			continue;
+		solver.constraints.emplace_back(i);
+
+		solver_neighborhood_t n = minesweeper_solver_neighborhood(solver, tiles, x_tiles, y_tiles, i);
+		uint32_t first = ~uint32_t{ 0 };
+		for (uint32_t bits = n.unknown_mask; bits; bits &= bits - 1) {
+			uint32_t tile = n.tile[std::countr_zero(bits)];
+			if (solver.column[tile] == ~uint32_t{ 0 }) {
+				solver.column[tile] = solver.frontier.size();
+				solver.frontier.emplace_back(tile);
+				solver.parent.emplace_back(solver.column[tile]);
+			}
+			if (first == ~uint32_t{ 0 })
+				first = solver.column[tile];
+			else
+				solver.parent[minesweeper_solver_find(solver.parent, solver.column[tile])] = minesweeper_solver_find(solver.parent, first);
+		}
+	}
+
+	// number the components, then counting sort frontier tiles and constraints by component
+	std::vector<uint32_t>& component = solver.scratch;
+	component.assign(solver.frontier.size(), ~uint32_t{ 0 });
+	uint32_t components = 0;
+	for (size_t c = 0; c < solver.frontier.size(); c++) {
+		uint32_t root = minesweeper_solver_find(solver.parent, c);
+		if (component[root] == ~uint32_t{ 0 })
+			component[root] = components++;
+		component[c] = component[root];
+	}
+
+	solver.frontier_start.assign(components + 1, 0);
+	solver.constraint_start.assign(components + 1, 0);
+	for (size_t c = 0; c < solver.frontier.size(); c++)
+		solver.frontier_start[component[c] + 1]++;
+	for (size_t c = 0; c < solver.constraints.size(); c++) {
+		solver_neighborhood_t n = minesweeper_solver_neighborhood(solver, tiles, x_tiles, y_tiles, solver.constraints[c]);
+		solver.constraint_start[component[solver.column[n.tile[std::countr_zero(n.unknown_mask)]]] + 1]++;
+	}
+	for (size_t c = 0; c < components; c++) {
+		solver.frontier_start[c + 1] += solver.frontier_start[c];
+		solver.constraint_start[c + 1] += solver.constraint_start[c];
+	}
+
+	std::vector<uint32_t> frontier(solver.frontier.size());
+	std::vector<uint32_t> constraints(solver.constraints.size());
+	std::vector<uint32_t> fill_frontier(solver.frontier_start.begin(), solver.frontier_start.end() - 1);
+	std::vector<uint32_t> fill_constraints(solver.constraint_start.begin(), solver.constraint_start.end() - 1);
+	for (size_t c = 0; c < solver.frontier.size(); c++)
+		frontier[fill_frontier[component[c]]++] = solver.frontier[c];
+	for (size_t c = 0; c < solver.constraints.size(); c++) {
+		solver_neighborhood_t n = minesweeper_solver_neighborhood(solver, tiles, x_tiles, y_tiles, solver.constraints[c]);
+		constraints[fill_constraints[component[solver.column[n.tile[std::countr_zero(n.unknown_mask)]]]]++] = solver.constraints[c];
+	}
+	solver.frontier.swap(frontier);
+	solver.constraints.swap(constraints);
+	for (size_t c = 0; c < solver.frontier.size(); c++)
+		solver.column[solver.frontier[c]] = c;
+
+	return components;
+}
+
+// sparse elimination over one frontier component. every number is a row "sum of its unknown tiles = mines left",
+// rows are combined only while coefficients stay in {-1, 0, 1} so a row fits in two bitsets, then each reduced row
+// is checked against its 0/1 bounds: if the rhs equals the most (or least) the row can sum to, every tile is decided.
+inline size_t minesweeper_solve_linear_component(minesweeper_solver_t& solver, const std::vector<mine>& tiles, uint32_t x_tiles, uint32_t y_tiles, uint32_t component) {
+	uint32_t first_column = solver.frontier_start[component];
+	uint32_t columns = solver.frontier_start[component + 1] - first_column;
+	uint32_t first_row = solver.constraint_start[component];
+	uint32_t rows = solver.constraint_start[component + 1] - first_row;
+	uint32_t words = (columns + 63) / 64;
+
+	solver.row_pos.assign(size_t{ rows } * words, 0);
+	solver.row_neg.assign(size_t{ rows } * words, 0);
+	solver.row_rhs.resize(rows);
+
+	for (uint32_t r = 0; r < rows; r++) {
+		solver_neighborhood_t n = minesweeper_solver_neighborhood(solver, tiles, x_tiles, y_tiles, solver.constraints[first_row + r]);
+		if (n.mines_left > 8)
+			return 0; // inconsistent board, nothing can be trusted
+		solver.row_rhs[r] = n.mines_left;
+		for (uint32_t bits = n.unknown_mask; bits; bits &= bits - 1) {
+			uint32_t c = solver.column[n.tile[std::countr_zero(bits)]] - first_column;
+			solver.row_pos[size_t{ r } * words + c / 64] |= uint64_t{ 1 } << (c % 64);
+		}
+	}
+
+	uint64_t* pos = solver.row_pos.data();
+	uint64_t* neg = solver.row_neg.data();
+	int32_t* rhs = solver.row_rhs.data();
+
+	uint32_t rank = 0;
+	for (uint32_t c = 0; c < columns && rank < rows; c++) {
+		uint32_t w = c / 64;
+		uint64_t bit = uint64_t{ 1 } << (c % 64);
+
+		uint32_t pivot = rank;
+		while (pivot < rows && !((pos[size_t{ pivot } * words + w] | neg[size_t{ pivot } * words + w]) & bit))
+			pivot++;
+		if (pivot == rows)
+			continue;
+
+		if (pivot != rank) {
+			std::swap_ranges(pos + size_t{ pivot } * words, pos + size_t{ pivot + 1 } * words, pos + size_t{ rank } * words);
+			std::swap_ranges(neg + size_t{ pivot } * words, neg + size_t{ pivot + 1 } * words, neg + size_t{ rank } * words);
+			std::swap(rhs[pivot], rhs[rank]);
+		}
+
+		uint64_t* p_pos = pos + size_t{ rank } * words;
+		uint64_t* p_neg = neg + size_t{ rank } * words;
+		bool pivot_positive = p_pos[w] & bit;
+
+		for (uint32_t r = 0; r < rows; r++) {
+			if (r == rank)
+				continue;
+			uint64_t* r_pos = pos + size_t{ r } * words;
+			uint64_t* r_neg = neg + size_t{ r } * words;
+			if (!((r_pos[w] | r_neg[w]) & bit))
+				continue;
+
+			// same sign at the pivot: subtract the pivot row, otherwise add it
+			bool subtract = ((r_pos[w] & bit) != 0) == pivot_positive;
+			const uint64_t* o_pos = subtract ? p_neg : p_pos;
+			const uint64_t* o_neg = subtract ? p_pos : p_neg;
+
+			uint64_t conflict = 0;
+			for (uint32_t i = 0; i < words; i++)
+				conflict |= (r_pos[i] & o_pos[i]) | (r_neg[i] & o_neg[i]);
+			if (conflict)
+				continue; // would need a coefficient of +-2, keep the row as is
+
+			for (uint32_t i = 0; i < words; i++) {
+				uint64_t any_pos = r_pos[i] | o_pos[i];
+				uint64_t any_neg = r_neg[i] | o_neg[i];
+				r_pos[i] = any_pos & ~any_neg;
+				r_neg[i] = any_neg & ~any_pos;
+			}
+			rhs[r] += subtract ? -rhs[rank] : rhs[rank];
+		}
+		rank++;
+	}
+
+	size_t found = solver.safe.size() + solver.mines.size();
+	for (uint32_t r = 0; r < rows; r++) {
+		const uint64_t* r_pos = pos + size_t{ r } * words;
+		const uint64_t* r_neg = neg + size_t{ r } * words;
+		int32_t most = 0;
+		int32_t least = 0;
+		for (uint32_t i = 0; i < words; i++) {
+			most += std::popcount(r_pos[i]);
+			least -= std::popcount(r_neg[i]);
+		}
+		if (most == least || (rhs[r] != most && rhs[r] != least))
+			continue;
+
+		// at the upper bound positive tiles are mines and negative tiles safe, at the lower bound the reverse
+		solver_mark pos_mark = rhs[r] == most ? solver_mark::mine : solver_mark::safe;
+		solver_mark neg_mark = rhs[r] == most ? solver_mark::safe : solver_mark::mine;
+		for (uint32_t i = 0; i < words; i++) {
+			for (uint64_t bits = r_pos[i]; bits; bits &= bits - 1)
+				minesweeper_solver_mark(solver, tiles, x_tiles, y_tiles, solver.frontier[first_column + i * 64 + std::countr_zero(bits)], pos_mark);
+			for (uint64_t bits = r_neg[i]; bits; bits &= bits - 1)
+				minesweeper_solver_mark(solver, tiles, x_tiles, y_tiles, solver.frontier[first_column + i * 64 + std::countr_zero(bits)], neg_mark);
+		}
+	}
+	return (solver.safe.size() + solver.mines.size()) - found;
+}
+
+inline size_t minesweeper_solve_linear(minesweeper_solver_t& solver, const std::vector<mine>& tiles, uint32_t x_tiles, uint32_t y_tiles) {
+	size_t found = 0;
+	size_t components = minesweeper_solver_frontier(solver, tiles, x_tiles, y_tiles);
+	for (size_t c = 0; c < components; c++)
+		found += minesweeper_solve_linear_component(solver, tiles, x_tiles, y_tiles, c);
+	return found;
+}
+
+// components up to this many tiles are enumerated one assignment per word
+constexpr uint32_t solver_component_tiles = 32;
+// past this many frontier tiles the per component tables get too large to combine, fall back to the density
+constexpr uint32_t solver_component_frontier = 512;
+
+// brute force over one component at a time. an assignment is a word with bit i set when cell i is a mine, cells
+// are decided in board order and after each one only the numbers touching it are checked with and + popcount,
+// so only assignments that still fit every number are walked.
+struct solver_enum_t {
+	uint32_t cells = 0;
+	std::vector<uint32_t> masks; // per number of the component, bit i set if it touches cell i
+	std::vector<int32_t> rhs; // mines each number still needs
+	std::array<std::array<uint16_t, 8>, solver_component_tiles> cell_constraints = {}; // numbers touching each cell
+	std::array<uint8_t, solver_component_tiles> cell_constraint_count = {};
+	std::array<double, solver_component_tiles + 1> count = {}; // assignments by mines in the component
+	std::array<double, (solver_component_tiles + 1) * solver_component_tiles> cell_mines = {}; // [k * 32 + cell] of those with cell a mine
+
+	std::vector<double> dist; // per component, count scaled so its largest entry is 1, stride solver_component_tiles + 1
+	std::vector<double> cell_dist; // per frontier tile, cell_mines with the same scale and stride
+	std::vector<double> weight; // ways to place the mines left outside the frontier, by mines in the frontier
+	std::vector<double> tail; // per component j, weighted completions by components j.. given the mines used before j
+	std::vector<double> head; // mines used by the components before j
+	std::vector<double> next;
+};
+
+// with this few unknown tiles left the exact solver is cheap enough to run every move
+constexpr uint32_t solver_endgame_tiles = 64;
+
+struct solver_exact_node_t {
+	uint32_t pos = 0;
+	std::array<uint32_t, 2> child = { ~uint32_t{ 0 }, ~uint32_t{ 0 } }; // next node when cell pos is safe / a mine
+	std::vector<double> suffix; // assignments of cells pos.. indexed by how many mines they hold
+	std::vector<double> prefix; // assignments of cells ..pos-1 reaching this node, same indexing
+};
+
+// exact model of up to 64 unknown tiles as bits of a word. placements are enumerated cell by cell with popcount
+// bound checks, subtrees are memoized by their constraint signature (cell + mines still owed by every number
+// that straddles it), and the tiles outside the model are accounted for with binomials over the global mine count.
+struct solver_exact_t {
+	uint32_t cells = 0;
+	std::array<uint32_t, 64> tile = {};
+	std::vector<uint64_t> masks; // per number, bit i set if it touches cell i
+	std::vector<int32_t> residual; // per number, mines still to place during the search
+	std::vector<std::vector<uint32_t>> cell_constraints; // numbers touching each cell
+	std::vector<std::vector<uint32_t>> open; // per cell, numbers with cells both before and from it
+	uint32_t free_tiles = 0; // unknown tiles no number touches
+	int64_t mines_left = 0; // undecided mines, in the model and the free tiles
+
+	std::vector<solver_exact_node_t> nodes;
+	std::unordered_map<std::string, uint32_t> memo;
+	std::string key;
+
+	std::vector<double> weight; // relative weight of k mines landing in the model
+	std::array<double, 64> mine_weight = {};
+	std::array<double, 64> safe_weight = {};
+	double total = 0.0;
+	double free_probability = 0.0;
+
+	solver_enum_t components; // scratch for minesweeper_solve_components
+};
+
+inline double solver_log_choose(int64_t n, int64_t k) {
+	if (k < 0 || k > n)
+		return -INFINITY;
+	return std::lgamma(double(n + 1)) - std::lgamma(double(k + 1)) - std::lgamma(double(n - k + 1));
+}
+
+inline uint32_t minesweeper_exact_search(solver_exact_t& e, uint32_t pos) {
+	e.key.clear();
+	e.key.push_back((char)pos);
+	if (pos < e.cells) {
+		for (uint32_t k : e.open[pos])
+			e.key.push_back((char)e.residual[k]);
+	}
+	auto it = e.memo.find(e.key);
+	if (it != e.memo.end())
+		return it->second;
+
+	uint32_t idx = e.nodes.size();
+	e.memo.emplace(e.key, idx);
+	e.nodes.emplace_back();
+	e.nodes[idx].pos = pos;
+	e.nodes[idx].suffix.assign(e.cells - pos + 1, 0.0);
+	if (pos == e.cells) {
+		e.nodes[idx].suffix[0] = 1.0;
+		return idx;
+	}
+
+	uint64_t after = (pos + 1) < 64 ? (~uint64_t{ 0 } << (pos + 1)) : 0;
+	for (uint32_t v = 0; v < 2; v++) {
+		bool ok = true;
+		for (uint32_t k : e.cell_constraints[pos]) {
+			int32_t r = e.residual[k] - (int32_t)v;
+			ok &= r >= 0 && r <= std::popcount(e.masks[k] & after);
+		}
+		if (!ok)
+			continue;
+
+		for (uint32_t k : e.cell_constraints[pos])
+			e.residual[k] -= v;
+		uint32_t child = minesweeper_exact_search(e, pos + 1);
+		for (uint32_t k : e.cell_constraints[pos])
+			e.residual[k] += v;
+
+		e.nodes[idx].child[v] = child;
+		const std::vector<double>& sub = e.nodes[child].suffix;
+		for (size_t i = 0; i < sub.size(); i++)
+			e.nodes[idx].suffix[i + v] += sub[i];
+	}
+	return idx;
+}
+
+// builds the model from the current solver marks, false if the frontier doesn't fit or the board is inconsistent
+inline bool minesweeper_exact_build(solver_exact_t& e, minesweeper_solver_t& solver, const std::vector<mine>& tiles, uint32_t x_tiles, uint32_t y_tiles, uint64_t mine_count) {
+	size_t components = minesweeper_solver_frontier(solver, tiles, x_tiles, y_tiles);
+	if (solver.frontier.size() > 64)
+		return false;
+
+	int64_t decided_mines = 0;
+	uint32_t unknown = 0;
+	for (size_t i = 0; i < tiles.size(); i++) {
+		decided_mines += solver.marks[i] == (uint8_t)solver_mark::mine;
+		unknown += solver.marks[i] == (uint8_t)solver_mark::unknown;
+	}
+
+	// frontier is grouped by component, keep tiles of a component in board order so numbers straddle few cells
+	e.cells = solver.frontier.size();
+	for (size_t c = 0; c < components; c++)
+		std::sort(solver.frontier.begin() + solver.frontier_start[c], solver.frontier.begin() + solver.frontier_start[c + 1]);
+	for (uint32_t i = 0; i < e.cells; i++) {
+		e.tile[i] = solver.frontier[i];
+		solver.column[e.tile[i]] = i;
+	}
+	e.free_tiles = unknown - e.cells;
+	e.mines_left = (int64_t)mine_count - decided_mines;
+
+	e.masks.clear();
+	e.residual.clear();
+	e.cell_constraints.assign(e.cells, {});
+	e.open.assign(e.cells, {});
+	for (uint32_t tile : solver.constraints) {
+		solver_neighborhood_t n = minesweeper_solver_neighborhood(solver, tiles, x_tiles, y_tiles, tile);
+		if (n.mines_left > 8)
+			return false;
+		uint64_t mask = 0;
+		for (uint32_t bits = n.unknown_mask; bits; bits &= bits - 1)
+			mask |= uint64_t{ 1 } << solver.column[n.tile[std::countr_zero(bits)]];
+
+		uint32_t k = e.masks.size();
+		e.masks.emplace_back(mask);
+		e.residual.emplace_back(n.mines_left);
+		for (uint64_t bits = mask; bits; bits &= bits - 1)
+			e.cell_constraints[std::countr_zero(bits)].emplace_back(k);
+		uint32_t first = std::countr_zero(mask);
+		uint32_t last = 63 - std::countl_zero(mask);
+		for (uint32_t i = first + 1; i <= last; i++)
+			e.open[i].emplace_back(k);
+	}
+	return e.mines_left >= 0;
+}
+
+// counts every placement and derives per cell mine / safe weights with a forward pass over the memoized nodes
+inline void minesweeper_exact_solve(solver_exact_t& e) {
+	e.nodes.clear();
+	e.memo.clear();
+	uint32_t root = minesweeper_exact_search(e, 0);
+
+	// weight of k mines in the model = ways to put the other mines_left - k into the free tiles
+	e.weight.assign(e.cells + 1, 0.0);
+	double best = -INFINITY;
+	for (uint32_t k = 0; k <= e.cells; k++)
+		best = std::max(best, solver_log_choose(e.free_tiles, e.mines_left - k));
+	for (uint32_t k = 0; k <= e.cells && best != -INFINITY; k++)
+		e.weight[k] = std::exp(solver_log_choose(e.free_tiles, e.mines_left - k) - best);
+
+	e.total = 0.0;
+	double free_mines = 0.0;
+	const std::vector<double>& all = e.nodes[root].suffix;
+	for (uint32_t k = 0; k <= e.cells; k++) {
+		e.total += all[k] * e.weight[k];
+		free_mines += all[k] * e.weight[k] * double(e.mines_left - k);
+	}
+	e.free_probability = (e.total > 0.0 && e.free_tiles) ? free_mines / (e.total * e.free_tiles) : 0.0;
+
+	std::vector<std::vector<uint32_t>> by_pos(e.cells + 1);
+	for (uint32_t i = 0; i < e.nodes.size(); i++) {
+		e.nodes[i].prefix.assign(e.nodes[i].pos + 1, 0.0);
+		by_pos[e.nodes[i].pos].emplace_back(i);
+	}
+	e.nodes[root].prefix[0] = 1.0;
+
+	e.mine_weight.fill(0.0);
+	e.safe_weight.fill(0.0);
+	std::vector<double> through;
+	for (uint32_t pos = 0; pos < e.cells; pos++) {
+		for (uint32_t i : by_pos[pos]) {
+			for (uint32_t v = 0; v < 2; v++) {
+				uint32_t child = e.nodes[i].child[v];
+				if (child == ~uint32_t{ 0 })
+					continue;
+				solver_exact_node_t& c = e.nodes[child];
+				const std::vector<double>& prefix = e.nodes[i].prefix;
+				for (size_t p = 0; p < prefix.size(); p++)
+					c.prefix[p + v] += prefix[p];
+
+				// placements through this edge, by total mines in the model
+				through.assign(e.cells + 1, 0.0);
+				for (size_t p = 0; p < prefix.size(); p++) {
+					if (prefix[p] == 0.0)
+						continue;
+					for (size_t q = 0; q < c.suffix.size(); q++)
+						through[p + v + q] += prefix[p] * c.suffix[q];
+				}
+				double w = 0.0;
+				for (uint32_t k = 0; k <= e.cells; k++)
+					w += through[k] * e.weight[k];
+				(v ? e.mine_weight : e.safe_weight)[pos] += w;
+			}
+		}
+	}
+}
+
+// fills solver.probability from an exact model, tiles outside it share the free tile probability
+inline void minesweeper_exact_probabilities(const solver_exact_t& e, minesweeper_solver_t& solver) {
+	solver.probability.resize(solver.marks.size());
+	for (size_t i = 0; i < solver.marks.size(); i++) {
+		uint8_t mark = solver.marks[i];
+		solver.probability[i] = mark == (uint8_t)solver_mark::mine ? 1.0f : (mark == (uint8_t)solver_mark::safe ? 0.0f : (float)e.free_probability);
+	}
+	for (uint32_t c = 0; c < e.cells; c++)
+		solver.probability[e.tile[c]] = e.total > 0.0 ? (float)(e.mine_weight[c] / e.total) : 0.0f;
+}
+
+// near the end of a game the global mine count decides tiles no local reasoning can, solve the whole board exactly
+inline size_t minesweeper_solve_endgame(minesweeper_solver_t& solver, solver_exact_t& e, const std::vector<mine>& tiles, uint32_t x_tiles, uint32_t y_tiles, uint64_t mine_count) {
+	uint32_t unknown = 0;
+	for (size_t i = 0; i < tiles.size(); i++)
+		unknown += solver.marks[i] == (uint8_t)solver_mark::unknown;
+	if (!unknown || unknown > solver_endgame_tiles)
+		return 0;
+	if (!minesweeper_exact_build(e, solver, tiles, x_tiles, y_tiles, mine_count))
+		return 0;
+	minesweeper_exact_solve(e);
+	if (e.total <= 0.0)
+		return 0;
+	minesweeper_exact_probabilities(e, solver);
+
+	size_t found = solver.safe.size() + solver.mines.size();
+	// certainty comes from a weight being exactly zero, never from comparing probabilities to 1
+	for (uint32_t c = 0; c < e.cells; c++) {
+		if (e.mine_weight[c] == 0.0)
+			minesweeper_solver_mark(solver, tiles, x_tiles, y_tiles, e.tile[c], solver_mark::safe);
+		else if (e.safe_weight[c] == 0.0)
+			minesweeper_solver_mark(solver, tiles, x_tiles, y_tiles, e.tile[c], solver_mark::mine);
+	}
+	if (e.free_tiles && (e.free_probability == 0.0 || e.free_probability == 1.0)) {
+		solver_mark mark = e.free_probability == 0.0 ? solver_mark::safe : solver_mark::mine;
+		for (size_t i = 0; i < tiles.size(); i++) {
+			if (solver.marks[i] == (uint8_t)solver_mark::unknown && solver.column[i] == ~uint32_t{ 0 })
+				minesweeper_solver_mark(solver, tiles, x_tiles, y_tiles, i, mark);
+		}
+	}
+	return (solver.safe.size() + solver.mines.size()) - found;
+}
+
+inline void minesweeper_enum_search(solver_enum_t& en, uint32_t pos, uint32_t assignment) {
+	if (pos == en.cells) {
+		uint32_t k = std::popcount(assignment);
+		en.count[k] += 1.0;
+		for (uint32_t bits = assignment; bits; bits &= bits - 1)
+			en.cell_mines[k * solver_component_tiles + std::countr_zero(bits)] += 1.0;
+		return;
+	}
+	uint32_t after = pos + 1 < 32 ? ~uint32_t{ 0 } << (pos + 1) : 0;
+	for (uint32_t v = 0; v < 2; v++) {
+		uint32_t a = assignment | (v << pos);
+		bool ok = true;
+		for (uint32_t i = 0; i < en.cell_constraint_count[pos] && ok; i++) {
+			uint32_t k = en.cell_constraints[pos][i];
+			int32_t have = std::popcount(a & en.masks[k]);
+			ok = have <= en.rhs[k] && en.rhs[k] <= have + std::popcount(en.masks[k] & after);
+		}
+		if (ok)
+			minesweeper_enum_search(en, pos + 1, a);
+	}
+}
+
+// exact probabilities without the global model: every component is enumerated on its own, then the components
+// are combined with binomials over the global mine count. false if a component is too large or the board is inconsistent.
+inline bool minesweeper_solve_components(minesweeper_solver_t& solver, solver_enum_t& en, const std::vector<mine>& tiles, uint32_t x_tiles, uint32_t y_tiles, uint64_t mine_count) {
+	constexpr uint32_t stride = solver_component_tiles + 1;
+	size_t components = minesweeper_solver_frontier(solver, tiles, x_tiles, y_tiles);
+	uint32_t frontier = solver.frontier.size();
+	if (frontier > solver_component_frontier)
+		return false;
+	for (size_t c = 0; c < components; c++) {
+		if (solver.frontier_start[c + 1] - solver.frontier_start[c] > solver_component_tiles)
+			return false;
+	}
+
+	int64_t decided_mines = 0;
+	uint32_t unknown = 0;
+	for (size_t i = 0; i < tiles.size(); i++) {
+		decided_mines += solver.marks[i] == (uint8_t)solver_mark::mine;
+		unknown += solver.marks[i] == (uint8_t)solver_mark::unknown;
+	}
+	uint32_t free_tiles = unknown - frontier;
+	int64_t mines_left = (int64_t)mine_count - decided_mines;
+	if (mines_left < 0)
+		return false;
+
+	en.dist.assign(components * stride, 0.0);
+	en.cell_dist.assign(size_t{ frontier } * stride, 0.0);
+	for (size_t c = 0; c < components; c++) {
+		uint32_t first = solver.frontier_start[c];
+		en.cells = solver.frontier_start[c + 1] - first;
+		// board order keeps numbers straddling few cells, so bad prefixes are cut early
+		std::sort(solver.frontier.begin() + first, solver.frontier.begin() + solver.frontier_start[c + 1]);
+		for (uint32_t i = 0; i < en.cells; i++)
+			solver.column[solver.frontier[first + i]] = first + i;
+
+		en.masks.clear();
+		en.rhs.clear();
+		en.cell_constraint_count.fill(0);
+		for (uint32_t r = solver.constraint_start[c]; r < solver.constraint_start[c + 1]; r++) {
+			solver_neighborhood_t n = minesweeper_solver_neighborhood(solver, tiles, x_tiles, y_tiles, solver.constraints[r]);
+			if (n.mines_left > 8)
+				return false;
+			uint32_t mask = 0;
+			for (uint32_t bits = n.unknown_mask; bits; bits &= bits - 1)
+				mask |= uint32_t{ 1 } << (solver.column[n.tile[std::countr_zero(bits)]] - first);
+			uint32_t k = en.masks.size();
+			en.masks.emplace_back(mask);
+			en.rhs.emplace_back(n.mines_left);
+			for (uint32_t bits = mask; bits; bits &= bits - 1) {
+				uint32_t cell = std::countr_zero(bits);
+				en.cell_constraints[cell][en.cell_constraint_count[cell]++] = k;
+			}
+		}
+
+		std::fill(en.count.begin(), en.count.begin() + en.cells + 1, 0.0);
+		std::fill(en.cell_mines.begin(), en.cell_mines.begin() + (en.cells + 1) * solver_component_tiles, 0.0);
+		minesweeper_enum_search(en, 0, 0);
+
+		double largest = *std::max_element(en.count.begin(), en.count.begin() + en.cells + 1);
+		if (largest == 0.0)
+			return false;
+		for (uint32_t k = 0; k <= en.cells; k++) {
+			en.dist[c * stride + k] = en.count[k] / largest;
+			for (uint32_t i = 0; i < en.cells; i++)
+				en.cell_dist[size_t{ first + i } * stride + k] = en.cell_mines[k * solver_component_tiles + i] / largest;
+		}
+	}
+
+	// weight of m mines in the frontier = ways to put the other mines_left - m into the free tiles
+	en.weight.assign(frontier + 1, 0.0);
+	double best = -INFINITY;
+	for (uint32_t m = 0; m <= frontier; m++)
+		best = std::max(best, solver_log_choose(free_tiles, mines_left - m));
+	if (best == -INFINITY)
+		return false;
+	for (uint32_t m = 0; m <= frontier; m++)
+		en.weight[m] = std::exp(solver_log_choose(free_tiles, mines_left - m) - best);
+
+	// tail[j][m]: weighted ways for components j.. to finish when the components before j hold m mines,
+	// each row rescaled on its own since only ratios within a row are ever used
+	size_t row = size_t{ frontier } + 1;
+	en.tail.assign((components + 1) * row, 0.0);
+	std::copy(en.weight.begin(), en.weight.end(), en.tail.begin() + components * row);
+	for (size_t j = components; j-- > 0;) {
+		uint32_t cells = solver.frontier_start[j + 1] - solver.frontier_start[j];
+		double* out = &en.tail[j * row];
+		const double* in = &en.tail[(j + 1) * row];
+		double largest = 0.0;
+		for (uint32_t m = 0; m + cells <= frontier; m++) {
+			double sum = 0.0;
+			for (uint32_t k = 0; k <= cells; k++)
+				sum += en.dist[j * stride + k] * in[m + k];
+			out[m] = sum;
+			largest = std::max(largest, sum);
+		}
+		if (largest == 0.0)
+			return false;
+		for (uint32_t m = 0; m <= frontier; m++)
+			out[m] /= largest;
+	}
+
+	// walk forward keeping the distribution of mines used so far, every cell is head * its counts * tail
+	solver.probability.resize(tiles.size());
+	en.head.assign(row, 0.0);
+	en.head[0] = 1.0;
+	uint32_t used = 0; // largest mine count head can hold
+	for (size_t j = 0; j < components; j++) {
+		uint32_t first = solver.frontier_start[j];
+		uint32_t cells = solver.frontier_start[j + 1] - first;
+		const double* after = &en.tail[(j + 1) * row];
+		double total = 0.0;
+		for (uint32_t m = 0; m <= used; m++) {
+			if (en.head[m] == 0.0)
+				continue;
+			for (uint32_t k = 0; k <= cells; k++)
+				total += en.head[m] * en.dist[j * stride + k] * after[m + k];
+		}
+		if (total <= 0.0)
+			return false;
+		for (uint32_t i = 0; i < cells; i++) {
+			const double* cell = &en.cell_dist[size_t{ first + i } * stride];
+			double mines = 0.0;
+			for (uint32_t m = 0; m <= used; m++) {
+				if (en.head[m] == 0.0)
+					continue;
+				for (uint32_t k = 1; k <= cells; k++)
+					mines += en.head[m] * cell[k] * after[m + k];
+			}
+			solver.probability[solver.frontier[first + i]] = (float)(mines / total);
+		}
+
+		en.next.assign(row, 0.0);
+		double largest = 0.0;
+		for (uint32_t m = 0; m <= used; m++) {
+			for (uint32_t k = 0; k <= cells; k++)
+				en.next[m + k] += en.head[m] * en.dist[j * stride + k];
+		}
+		used += cells;
+		for (uint32_t m = 0; m <= used; m++)
+			largest = std::max(largest, en.next[m]);
+		for (uint32_t m = 0; m <= used; m++)
+			en.head[m] = en.next[m] / largest;
+	}
+
+	// head now holds every frontier mine count, the free tiles share what is left
+	double total = 0.0;
+	double free_mines = 0.0;
+	for (uint32_t m = 0; m <= frontier; m++) {
+		total += en.head[m] * en.weight[m];
+		free_mines += en.head[m] * en.weight[m] * double(mines_left - m);
+	}
+	if (total <= 0.0)
+		return false;
+	float free_probability = free_tiles ? (float)(free_mines / (total * free_tiles)) : 0.0f;
+	for (size_t i = 0; i < tiles.size(); i++) {
+		uint8_t mark = solver.marks[i];
+		if (mark == (uint8_t)solver_mark::mine)
+			solver.probability[i] = 1.0f;
+		else if (mark == (uint8_t)solver_mark::safe)
+			solver.probability[i] = 0.0f;
+		else if (solver.column[i] == ~uint32_t{ 0 })
+			solver.probability[i] = free_probability;
+	}
+	return true;
+}
+
+enum class solver_probabilities : uint8_t {
+	density = 0, // frontier too large, every undecided tile gets the average density of the mines left
+	components = 1, // exact, from the component enumerator
+	model = 2, // exact, and e holds the model minesweeper_exact_sample draws from
+};
+
+// mine probability of every tile into solver.probability. model asks for e to be built whenever the frontier fits,
+// without it small components are enumerated directly, which is much cheaper for callers that only need the numbers.
+inline solver_probabilities minesweeper_solve_probabilities(minesweeper_solver_t& solver, solver_exact_t& e, const std::vector<mine>& tiles, uint32_t x_tiles, uint32_t y_tiles, uint64_t mine_count, bool model = true) {
+	if (!model && minesweeper_solve_components(solver, e.components, tiles, x_tiles, y_tiles, mine_count))
+		return solver_probabilities::components;
+	if (minesweeper_exact_build(e, solver, tiles, x_tiles, y_tiles, mine_count)) {
+		minesweeper_exact_solve(e);
+		if (e.total > 0.0) {
+			minesweeper_exact_probabilities(e, solver);
+			return solver_probabilities::model;
+		}
+	}
+	else if (model && minesweeper_solve_components(solver, e.components, tiles, x_tiles, y_tiles, mine_count))
+		return solver_probabilities::components;
+
+	int64_t decided_mines = 0;
+	uint32_t unknown = 0;
+	for (size_t i = 0; i < tiles.size(); i++) {
+		decided_mines += solver.marks[i] == (uint8_t)solver_mark::mine;
+		unknown += solver.marks[i] == (uint8_t)solver_mark::unknown;
+	}
+	float density = unknown ? std::clamp(float((int64_t)mine_count - decided_mines) / unknown, 0.0f, 1.0f) : 0.0f;
+	solver.probability.resize(tiles.size());
+	for (size_t i = 0; i < tiles.size(); i++) {
+		uint8_t mark = solver.marks[i];
+		solver.probability[i] = mark == (uint8_t)solver_mark::mine ? 1.0f : (mark == (uint8_t)solver_mark::safe ? 0.0f : density);
+	}
+	return solver_probabilities::density;
+}
+
+// local pattern pass: table lookups for single numbers then pairs of numbers until nothing changes
+inline size_t minesweeper_solve_patterns(minesweeper_solver_t& solver, const std::vector<mine>& tiles, uint32_t x_tiles, uint32_t y_tiles) {
+	size_t found = 0;
+	for (;;) {
+		found += minesweeper_solve_single(solver, tiles, x_tiles, y_tiles);
+		size_t pairs = minesweeper_solve_pairs(solver, tiles, x_tiles, y_tiles);
+		if (!pairs)
+			break;
+		found += pairs;
+	}
+	return found;
+}
+
+// patterns and elimination until neither finds anything, everything that doesn't need the global mine count
+inline size_t minesweeper_solve_local(minesweeper_solver_t& solver, const std::vector<mine>& tiles, uint32_t x_tiles, uint32_t y_tiles) {
+	size_t found = minesweeper_solve_patterns(solver, tiles, x_tiles, y_tiles);
+	// patterns are cheap, only fall back to elimination once they're stuck
+	for (;;) {
+		size_t linear = minesweeper_solve_linear(solver, tiles, x_tiles, y_tiles);
+		if (!linear)
+			break;
+		found += linear + minesweeper_solve_patterns(solver, tiles, x_tiles, y_tiles);
+	}
+	return found;
+}
+
+// continues from the marks already in solver, the work list must hold every number whose neighborhood changed
+inline size_t minesweeper_solve_resume(minesweeper_solver_t& solver, const std::vector<mine>& tiles, uint32_t x_tiles, uint32_t y_tiles, uint64_t mine_count) {
+	size_t found = minesweeper_solve_local(solver, tiles, x_tiles, y_tiles);
+
+	solver_exact_t endgame;
+	for (;;) {
+		size_t exact = minesweeper_solve_endgame(solver, endgame, tiles, x_tiles, y_tiles, mine_count);
+		if (!exact)
+			break;
+		found += exact + minesweeper_solve_patterns(solver, tiles, x_tiles, y_tiles);
+	}
+	return found;
+}
+
+// fills solver.safe / solver.mines with every hidden tile that can be decided from the visible board
+inline size_t minesweeper_solve(minesweeper_solver_t& solver, const std::vector<mine>& tiles, uint32_t x_tiles, uint32_t y_tiles, uint64_t mine_count) {
+	minesweeper_solver_reset(solver, tiles);
+	return minesweeper_solve_resume(solver, tiles, x_tiles, y_tiles, mine_count);
+}
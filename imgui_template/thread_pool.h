@@ -0,0 +1,162 @@
+﻿// thread_pool.h : work stealing thread pool used by the solver search and the batch tools.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// counts outstanding tasks so a caller can wait on just the work it submitted
+struct task_group_t {
+	std::atomic<size_t> pending = { 0 };
+};
+
+struct thread_pool_t {
+	struct worker_t {
+		std::mutex lock;
+		std::deque<std::function<void()>> tasks;
+	};
+
+	std::vector<std::unique_ptr<worker_t>> workers;
+	std::vector<std::thread> threads;
+	std::mutex sleep_lock;
+	std::condition_variable wake;
+	std::atomic<size_t> queued = { 0 };
+	std::atomic<size_t> sleepers = { 0 }; // workers in or about to enter wake.wait
+	std::atomic<size_t> next_queue = { 0 };
+	std::atomic<bool> stopping = { false };
+
+	// index of the pool worker running on this thread, or size() for threads outside the pool
+	static inline thread_local const thread_pool_t* current_pool = nullptr;
+	static inline thread_local size_t current_index = 0;
+
+	explicit thread_pool_t(size_t thread_count = std::thread::hardware_concurrency()) {
+		thread_count = thread_count ? thread_count : 1;
+		for (size_t i = 0; i < thread_count; i++)
+			workers.emplace_back(std::make_unique<worker_t>());
+		for (size_t i = 0; i < thread_count; i++)
+			threads.emplace_back([this, i] { run(i); });
+	}
+
+	~thread_pool_t() {
+		{
+			std::lock_guard<std::mutex> guard(sleep_lock);
+			stopping = true;
+		}
+		wake.notify_all();
+		for (std::thread& t : threads)
+			t.join();
+	}
+
+	thread_pool_t(const thread_pool_t&) = delete;
+	thread_pool_t& operator=(const thread_pool_t&) = delete;
+
+	size_t size() const {
+		return workers.size();
+	}
+
+	size_t worker_index() const {
+		return current_pool == this ? current_index : size();
+	}
+
+	// workers push to the back of their own queue and pop from the back (newest first, cache warm),
+	// idle workers steal from the front of someone else's queue (oldest, usually the biggest chunk of work)
+	void submit(task_group_t& group, std::function<void()> task) {
+		group.pending.fetch_add(1, std::memory_order_relaxed);
+		size_t index = worker_index();
+		if (index == size())
+			index = next_queue.fetch_add(1, std::memory_order_relaxed) % size();
+
+		{
+			std::lock_guard<std::mutex> guard(workers[index]->lock);
+			workers[index]->tasks.emplace_back([&group, task = std::move(task)] {
+				task();
+				group.pending.fetch_sub(1, std::memory_order_release);
+			});
+		}
+		// parallel_for submits from every worker at once, only touch sleep_lock when someone can be woken.
+		// queued is raised before sleepers is read and a worker raises sleepers before reading queued,
+		// so either this sees the sleeper or the sleeper sees the task
+		queued.fetch_add(1, std::memory_order_seq_cst);
+		if (!sleepers.load(std::memory_order_seq_cst))
+			return;
+		{
+			// a worker between checking queued and going to sleep must not miss this
+			std::lock_guard<std::mutex> guard(sleep_lock);
+		}
+		wake.notify_one();
+	}
+
+	bool try_run_one(size_t index) {
+		std::function<void()> task;
+		if (index < size()) {
+			worker_t& own = *workers[index];
+			std::lock_guard<std::mutex> guard(own.lock);
+			if (own.tasks.size()) {
+				task = std::move(own.tasks.back());
+				own.tasks.pop_back();
+			}
+		}
+		for (size_t i = 1; !task && i <= size(); i++) {
+			worker_t& victim = *workers[(index + i) % size()];
+			std::lock_guard<std::mutex> guard(victim.lock);
+			if (victim.tasks.size()) {
+				task = std::move(victim.tasks.front());
+				victim.tasks.pop_front();
+			}
+		}
+		if (!task)
+			return false;
+		queued.fetch_sub(1, std::memory_order_relaxed);
+		task();
+		return true;
+	}
+
+	// runs queued tasks on the calling thread until the group is finished, safe to call from inside a task
+	void wait(task_group_t& group) {
+		size_t index = worker_index();
+		while (group.pending.load(std::memory_order_acquire)) {
+			if (!try_run_one(index))
+				std::this_thread::yield();
+		}
+	}
+
+	void run(size_t index) {
+		current_pool = this;
+		current_index = index;
+		while (!stopping.load(std::memory_order_acquire)) {
+			if (try_run_one(index))
+				continue;
+			std::unique_lock<std::mutex> guard(sleep_lock);
+			sleepers.fetch_add(1, std::memory_order_seq_cst);
+			wake.wait(guard, [this] { return stopping.load(std::memory_order_acquire) || queued.load(std::memory_order_seq_cst); });
+			sleepers.fetch_sub(1, std::memory_order_relaxed);
+		}
+	}
+};
+
+// splits [begin, end) in half until pieces are at most grain long, so idle workers steal large ranges first.
+// fn(i, worker_index) is called once per index, worker_index is < pool.size() + 1 and usable for per thread scratch.
+template<typename Fn>
+void parallel_for(thread_pool_t& pool, size_t begin, size_t end, size_t grain, Fn&& fn) {
+	task_group_t group;
+	grain = grain ? grain : 1;
+	std::function<void(size_t, size_t)> split = [&](size_t lo, size_t hi) {
+		while (hi - lo > grain) {
+			size_t mid = lo + (hi - lo) / 2;
+			pool.submit(group, [&split, mid, hi] { split(mid, hi); });
+			hi = mid;
+		}
+		size_t worker = pool.worker_index();
+		for (size_t i = lo; i < hi; i++)
+			fn(i, worker);
+	};
+	if (begin < end)
+		split(begin, end);
+	pool.wait(group);
+}